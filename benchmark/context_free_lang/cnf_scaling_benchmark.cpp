@@ -0,0 +1,39 @@
+/*!
+ * \file cnf_scaling_benchmark.cpp
+ *
+ * \brief thread scaling of parallel CYK over grammar sizes and input lengths
+ */
+
+#include <string>
+
+#include "context_free_lang/cnf.hpp"
+#include "helper.hpp"
+#include "workload.hpp"
+
+using namespace cyy::computation;
+using namespace cyy::computation::benchmark;
+
+int main() {
+  ALPHABET_ptr const ab_set = ALPHABET::get("ab_set");
+  auto const ab_symbols = get_symbols(ab_set);
+  for (size_t const nonterminal_number : {32, 128}) {
+    CFG cfg(ab_set, "N0",
+            random_CFG_productions(nonterminal_number, 3, ab_symbols));
+    cfg.to_CNF();
+    CNF const cnf(std::move(cfg));
+    for (size_t const length : {500, 1000, 2000}) {
+      auto const input = random_string(length, ab_symbols);
+      for (size_t const thread_number : {1, 2, 4, 8}) {
+        run_benchmark("CNF_parallel_parse",
+                      {{"nonterminals", nonterminal_number},
+                       {"length", length},
+                       {"threads", thread_number}},
+                      input.size(), 1, [&]() {
+                        static_cast<void>(
+                            cnf.parallel_parse(input, thread_number));
+                      });
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,149 @@
+/*!
+ * \file grammar_benchmark.cpp
+ *
+ * \brief table construction, normal form conversion and parsing throughput
+ * over LR-able and random grammars
+ */
+
+#include <functional>
+#include <string>
+
+#include "context_free_lang/cnf.hpp"
+#include "context_free_lang/dk.hpp"
+#include "context_free_lang/dk_1.hpp"
+#include "context_free_lang/earley_parser.hpp"
+#include "context_free_lang/lalr_grammar.hpp"
+#include "context_free_lang/minimal_lr_grammar.hpp"
+#include "helper.hpp"
+#include "workload.hpp"
+
+using namespace cyy::computation;
+using namespace cyy::computation::benchmark;
+
+namespace {
+  bool LR_parse(const LR_grammar &grammar, symbol_string_view tokens) {
+    return grammar.parse(tokens, [](auto) {}, [](auto const &) {});
+  }
+
+  size_t get_state_number(const LR_1_grammar &grammar) {
+    size_t state_number = 0;
+    for (auto const &[_, set] : grammar.get_collection().first) {
+      if (!set.empty()) {
+        state_number++;
+      }
+    }
+    return state_number;
+  }
+
+  //! the time to build the parsing table with the number of its states
+  template <typename grammar_type>
+  void benchmark_LR_table(std::string_view name,
+                          const CFG::nonterminal_type &start_symbol,
+                          const CFG::production_set_type &productions,
+                          symbol_string_view tokens) {
+    benchmark_parameters const parameters{
+        {"states",
+         get_state_number(
+             grammar_type("common_tokens", start_symbol, productions))}};
+    // the parsing table is built by the first parse
+    run_benchmark(name, parameters, 0, 3, [&]() {
+      grammar_type grammar("common_tokens", start_symbol, productions);
+      static_cast<void>(LR_parse(grammar, tokens));
+    });
+  }
+
+  void benchmark_LR_grammar(std::string_view name,
+                            const CFG::nonterminal_type &start_symbol,
+                            const CFG::production_set_type &productions,
+                            const std::function<symbol_string(size_t)>
+                                &token_generator) {
+    auto const small_tokens = token_generator(1);
+    CFG const cfg("common_tokens", start_symbol, productions);
+    run_benchmark(std::string(name) + "_DK_1_DFA", 3, [&]() {
+      static_cast<void>(DK_1_DFA(cfg));
+    });
+    benchmark_LR_table<LALR_grammar>(std::string(name) + "_LALR_table",
+                                     start_symbol, productions, small_tokens);
+    benchmark_LR_table<minimal_LR_grammar>(
+        std::string(name) + "_minimal_LR_table", start_symbol, productions,
+        small_tokens);
+    benchmark_LR_table<canonical_LR_grammar>(
+        std::string(name) + "_canonical_LR_table", start_symbol, productions,
+        small_tokens);
+
+    LALR_grammar grammar("common_tokens", start_symbol, productions);
+    static_cast<void>(LR_parse(grammar, small_tokens));
+    for (size_t const token_number : {1000, 10000, 100000}) {
+      auto const tokens = token_generator(token_number);
+      run_benchmark(std::string(name) + "_LALR_parse",
+                    {{"tokens", tokens.size()}}, tokens.size(), 3,
+                    [&]() { static_cast<void>(LR_parse(grammar, tokens)); });
+      run_benchmark(std::string(name) + "_GLR_parse",
+                    {{"tokens", tokens.size()}}, tokens.size(), 3,
+                    [&]() { static_cast<void>(grammar.GLR_parse(tokens)); });
+    }
+    Earley_parser const parser(cfg);
+    for (size_t const token_number : {1000, 10000}) {
+      auto const tokens = token_generator(token_number);
+      run_benchmark(std::string(name) + "_Earley_recognize",
+                    {{"tokens", tokens.size()}}, tokens.size(), 3,
+                    [&]() { static_cast<void>(parser.recognize(tokens)); });
+    }
+  }
+
+  void benchmark_CNF(
+      std::string_view name, const CFG &cfg,
+      const std::function<symbol_string(size_t)> &input_generator,
+      const benchmark_parameters &parameters) {
+    run_benchmark(std::string(name) + "_to_CNF", parameters, 0, 3, [&]() {
+      auto copy = cfg;
+      copy.to_CNF();
+    });
+    auto copy = cfg;
+    copy.to_CNF();
+    CNF const cnf(std::move(copy));
+    for (size_t const length : {16, 32, 64}) {
+      auto const input = input_generator(length);
+      auto input_parameters = parameters;
+      input_parameters.emplace_back("length", input.size());
+      run_benchmark(std::string(name) + "_CNF_parse", input_parameters,
+                    input.size(), 3,
+                    [&]() { static_cast<void>(cnf.parse(input)); });
+    }
+  }
+} // namespace
+
+int main() {
+  benchmark_LR_grammar("expression", "E", get_expression_productions(),
+                       [](size_t n) { return random_expression_tokens(n); });
+  benchmark_LR_grammar("JSON", "Value", get_JSON_productions(),
+                       [](size_t n) { return random_JSON_tokens(n); });
+
+  benchmark_CNF("expression",
+                CFG("common_tokens", "E", get_expression_productions()),
+                [](size_t n) { return random_expression_tokens(n); }, {});
+  ALPHABET_ptr const ab_set = ALPHABET::get("ab_set");
+  auto const ab_symbols = get_symbols(ab_set);
+  // LR(0) collections of grammars with 500 and more productions
+  for (size_t const nonterminal_number : {100, 200, 400}) {
+    CFG const cfg(ab_set, "N0",
+                  random_CFG_productions(nonterminal_number, 5, ab_symbols));
+    size_t production_number = 0;
+    for (auto const &[_, bodies] : cfg.get_productions()) {
+      production_number += bodies.size();
+    }
+    run_benchmark("random_CFG_DK_DFA",
+                  {{"nonterminals", nonterminal_number},
+                   {"productions", production_number}},
+                  0, 3, [&]() { static_cast<void>(DK_DFA(cfg)); });
+  }
+  for (size_t const nonterminal_number : {8, 32, 128}) {
+    benchmark_CNF("random_CFG",
+                  CFG(ab_set, "N0",
+                      random_CFG_productions(nonterminal_number, 3,
+                                             ab_symbols)),
+                  [&](size_t n) { return random_string(n, ab_symbols); },
+                  {{"nonterminals", nonterminal_number}});
+  }
+  return 0;
+}
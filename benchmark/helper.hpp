@@ -0,0 +1,49 @@
+/*!
+ * \file helper.hpp
+ *
+ * \brief benchmark helper functions
+ */
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using benchmark_parameters =
+    std::vector<std::pair<std::string_view, size_t>>;
+
+//! Run fun for the given iterations and print the result as one JSON line.
+//! The parameters describe the workload, items is the number of symbols or
+//! tokens processed by one call of fun and gives the throughput if nonzero.
+template <typename F>
+void run_benchmark(std::string_view name,
+                   const benchmark_parameters &parameters, size_t items,
+                   size_t iterations, F &&fun) {
+  auto begin = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) {
+    fun();
+  }
+  auto end = std::chrono::steady_clock::now();
+  auto total_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+  auto ns_per_iteration =
+      static_cast<double>(total_ns) / static_cast<double>(iterations);
+  std::cout << "{\"name\":\"" << name << "\"";
+  for (auto const &[key, value] : parameters) {
+    std::cout << ",\"" << key << "\":" << value;
+  }
+  std::cout << ",\"iterations\":" << iterations
+            << ",\"ns_per_iteration\":" << ns_per_iteration;
+  if (items != 0 && ns_per_iteration > 0) {
+    std::cout << ",\"items_per_second\":"
+              << static_cast<double>(items) * 1e9 / ns_per_iteration;
+  }
+  std::cout << "}\n";
+}
+
+template <typename F>
+void run_benchmark(std::string_view name, size_t iterations, F &&fun) {
+  run_benchmark(name, {}, 0, iterations, std::forward<F>(fun));
+}
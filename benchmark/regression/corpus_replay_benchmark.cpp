@@ -0,0 +1,34 @@
+/*!
+ * \file corpus_replay_benchmark.cpp
+ *
+ * \brief replay the worst cases found by the performance fuzzing targets
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "helper.hpp"
+#include "performance_workload.hpp"
+
+int main() {
+  for (auto const &w : performance_fuzzing::workloads) {
+    std::filesystem::path const dir =
+        std::filesystem::path(PERFORMANCE_CORPUS_DIR) / w.name;
+    if (!std::filesystem::is_directory(dir)) {
+      continue;
+    }
+    for (auto const &entry : std::filesystem::directory_iterator(dir)) {
+      std::ifstream is(entry.path(), std::ios::binary);
+      std::vector<uint8_t> const data{std::istreambuf_iterator<char>(is),
+                                      std::istreambuf_iterator<char>()};
+      run_benchmark(std::string(w.name) + "_corpus_" +
+                        entry.path().filename().string(),
+                    {{"size", data.size()}}, 0, 3,
+                    [&]() { w.run(data.data(), data.size()); });
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+/*!
+ * \file arena_benchmark.cpp
+ *
+ * \brief allocation count and time of automaton construction with and
+ * without an arena
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "arena.hpp"
+#include "helper.hpp"
+#include "regular_lang/regex.hpp"
+
+namespace {
+  std::atomic_size_t allocation_count{0};
+} // namespace
+
+void *operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (auto *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace cyy::computation;
+
+namespace {
+  template <typename F> void count_allocations(std::string_view name, F &&fun) {
+    auto const begin_count = allocation_count.load();
+    fun();
+    std::cout << "{\"name\":\"" << name
+              << "\",\"allocations\":" << allocation_count.load() - begin_count
+              << "}\n";
+  }
+} // namespace
+
+int main() {
+  symbol_string const expr =
+      U"([a-z_][a-z0-9_]*|[0-9]+(\\.[0-9]+)?|\"[a-z ]*\")(,[a-z_]+)*";
+  regex const reg("printable-ASCII", expr);
+  auto const nfa = reg.to_NFA();
+
+  auto regex_to_DFA = [&reg]() { static_cast<void>(reg.to_DFA()); };
+  auto NFA_to_DFA = [&nfa]() { static_cast<void>(nfa.to_DFA()); };
+  auto with_arena = [](auto &fun) {
+    return [&fun]() {
+      arena_scope const arena;
+      fun();
+    };
+  };
+
+  count_allocations("regex_to_DFA", regex_to_DFA);
+  count_allocations("regex_to_DFA_arena", with_arena(regex_to_DFA));
+  count_allocations("NFA_to_DFA", NFA_to_DFA);
+  count_allocations("NFA_to_DFA_arena", with_arena(NFA_to_DFA));
+
+  run_benchmark("regex_to_DFA", 10, regex_to_DFA);
+  run_benchmark("regex_to_DFA_arena", 10, with_arena(regex_to_DFA));
+  run_benchmark("NFA_to_DFA", 10, NFA_to_DFA);
+  run_benchmark("NFA_to_DFA_arena", 10, with_arena(NFA_to_DFA));
+  return 0;
+}
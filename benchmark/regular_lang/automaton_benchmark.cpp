@@ -0,0 +1,55 @@
+/*!
+ * \file automaton_benchmark.cpp
+ *
+ * \brief construction and recognition over random automata and regexes
+ */
+
+#include "helper.hpp"
+#include "regular_lang/regex.hpp"
+#include "workload.hpp"
+
+using namespace cyy::computation;
+using namespace cyy::computation::benchmark;
+
+int main() {
+  ALPHABET_ptr const ascii = ALPHABET::get("printable-ASCII");
+  ALPHABET_ptr const ab_set = ALPHABET::get("ab_set");
+  auto const ascii_symbols = get_symbols(ascii);
+  auto const ab_symbols = get_symbols(ab_set);
+
+  for (size_t const state_number : {100, 1000}) {
+    auto const dfa = random_DFA(state_number, ascii);
+    run_benchmark("DFA_minimize", {{"states", state_number}}, 0, 3,
+                  [&]() { static_cast<void>(dfa.minimize()); });
+    for (size_t const length : {1000, 10000, 100000}) {
+      auto const input = random_string(length, ascii_symbols);
+      run_benchmark("DFA_recognize",
+                    {{"states", state_number}, {"length", length}}, length, 10,
+                    [&]() { static_cast<void>(dfa.recognize(input)); });
+    }
+  }
+
+  for (size_t const state_number : {8, 16, 32}) {
+    auto const nfa = random_NFA(state_number, ab_set);
+    run_benchmark("NFA_to_DFA", {{"states", state_number}}, 0, 3,
+                  [&]() { static_cast<void>(nfa.to_DFA()); });
+    for (size_t const length : {1000, 10000}) {
+      auto const input = random_string(length, ab_symbols);
+      run_benchmark("NFA_recognize",
+                    {{"states", state_number}, {"length", length}}, length, 3,
+                    [&]() { static_cast<void>(nfa.recognize(input)); });
+    }
+  }
+
+  for (size_t const size : {16, 64, 256}) {
+    auto const expr = random_regex(size, ab_symbols);
+    run_benchmark("regex_parse", {{"size", size}}, expr.size(), 10,
+                  [&]() { static_cast<void>(regex(ab_set, expr)); });
+    regex const reg(ab_set, expr);
+    run_benchmark("regex_to_DFA", {{"size", size}}, 0, 3,
+                  [&]() { static_cast<void>(reg.to_DFA()); });
+    run_benchmark("regex_to_NFA_to_DFA", {{"size", size}}, 0, 3,
+                  [&]() { static_cast<void>(reg.to_NFA().to_DFA()); });
+  }
+  return 0;
+}
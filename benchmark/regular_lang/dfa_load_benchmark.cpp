@@ -0,0 +1,42 @@
+/*!
+ * \file dfa_load_benchmark.cpp
+ *
+ * \brief compare building a DFA from regex with loading it from file
+ */
+
+#include "helper.hpp"
+#include "regular_lang/binary_format.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+int main() {
+  symbol_string expr;
+  for (auto const *keyword :
+       {U"auto", U"break", U"case", U"char", U"const", U"continue",
+        U"default", U"double", U"else", U"enum", U"extern", U"float", U"for",
+        U"goto", U"if", U"inline", U"int", U"long", U"register", U"return",
+        U"short", U"signed", U"sizeof", U"static", U"struct", U"switch",
+        U"typedef", U"union", U"unsigned", U"void", U"volatile", U"while"}) {
+    if (!expr.empty()) {
+      expr.push_back('|');
+    }
+    expr += keyword;
+  }
+  expr = U"[a-z]*(" + expr + U")[0-9]*";
+
+  auto path =
+      std::filesystem::temp_directory_path() / "dfa_load_benchmark.bin";
+  save_binary(regex("printable-ASCII", expr).to_DFA(), path);
+
+  run_benchmark("regex_to_DFA", 10, [&expr]() {
+    auto dfa = regex("printable-ASCII", expr).to_DFA();
+    static_cast<void>(dfa.recognize(U"xwhile1"));
+  });
+  run_benchmark("mapped_DFA_load", 1000, [&path]() {
+    mapped_DFA const dfa(path);
+    static_cast<void>(dfa.recognize(U"xwhile1"));
+  });
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,42 @@
+/*!
+ * \file frozen_nfa_benchmark.cpp
+ *
+ * \brief compare NFA simulation over hash maps and compressed sparse rows
+ */
+
+#include <iostream>
+
+#include "helper.hpp"
+#include "regular_lang/frozen_nfa.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+int main() {
+  symbol_string expr;
+  for (size_t i = 0; i < 200; i++) {
+    if (!expr.empty()) {
+      expr.push_back('|');
+    }
+    expr += U"[a-z]*";
+    expr += static_cast<symbol_type>('a' + (i % 26));
+    expr += static_cast<symbol_type>('a' + ((i * 7) % 26));
+    expr += U"[0-9]+";
+  }
+  auto const nfa = regex("printable-ASCII", expr).to_NFA();
+  frozen_NFA const frozen_nfa(nfa);
+  std::cout << "{\"name\":\"frozen_NFA_memory\",\"states\":"
+            << frozen_nfa.get_state_number()
+            << ",\"bytes\":" << frozen_nfa.get_memory_usage() << "}\n";
+
+  symbol_string const input = U"helloworldzh2024";
+  run_benchmark("NFA_recognize", 100,
+                [&]() { static_cast<void>(nfa.recognize(input)); });
+  run_benchmark("frozen_NFA_recognize", 100,
+                [&]() { static_cast<void>(frozen_nfa.recognize(input)); });
+  run_benchmark("NFA_to_DFA_with_mapping", 1,
+                [&]() { static_cast<void>(nfa.to_DFA_with_mapping()); });
+  run_benchmark("frozen_NFA_to_DFA", 1,
+                [&]() { static_cast<void>(frozen_nfa.to_DFA()); });
+  return 0;
+}
@@ -0,0 +1,221 @@
+/*!
+ * \file workload.hpp
+ *
+ * \brief synthetic workloads for benchmarks, generation is deterministic for
+ * a given seed
+ */
+#pragma once
+
+#include <random>
+#include <vector>
+
+#include "alphabet/common_tokens.hpp"
+#include "context_free_lang/cfg.hpp"
+#include "context_free_lang/common_grammar.hpp"
+#include "regular_lang/dfa.hpp"
+#include "regular_lang/nfa.hpp"
+
+namespace cyy::computation::benchmark {
+  inline std::vector<symbol_type> get_symbols(const ALPHABET_ptr &alphabet) {
+    std::vector<symbol_type> symbols;
+    for (auto const a : alphabet->get_view()) {
+      symbols.push_back(a);
+    }
+    return symbols;
+  }
+
+  //! Complete DFA with uniformly random transitions and final states
+  inline DFA random_DFA(size_t state_number, const ALPHABET_ptr &alphabet,
+                        uint64_t seed = 0) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<DFA::state_type> state_dist(
+        0, state_number - 1);
+    DFA::state_set_type states;
+    DFA::state_set_type final_states;
+    DFA::transition_function_type transition_function;
+    for (DFA::state_type s = 0; s < state_number; s++) {
+      states.insert(states.end(), s);
+      if (gen() % 2 == 0) {
+        final_states.insert(final_states.end(), s);
+      }
+      for (auto const a : alphabet->get_view()) {
+        transition_function[{s, a}] = state_dist(gen);
+      }
+    }
+    return {std::move(states), alphabet, 0, std::move(transition_function),
+            std::move(final_states)};
+  }
+
+  //! NFA where every state has about out_degree targets per symbol and one
+  //! epsilon transition in ten states
+  inline NFA random_NFA(size_t state_number, const ALPHABET_ptr &alphabet,
+                        size_t out_degree = 2, uint64_t seed = 0) {
+    std::mt19937_64 gen(seed);
+    std::uniform_int_distribution<NFA::state_type> state_dist(
+        0, state_number - 1);
+    NFA::state_set_type states;
+    NFA::state_set_type final_states;
+    NFA::transition_function_type transition_function;
+    NFA::epsilon_transition_function_type epsilon_transition_function;
+    for (NFA::state_type s = 0; s < state_number; s++) {
+      states.insert(states.end(), s);
+      if (gen() % 8 == 0) {
+        final_states.insert(final_states.end(), s);
+      }
+      for (auto const a : alphabet->get_view()) {
+        NFA::state_set_type next_states;
+        for (size_t i = 0; i < out_degree; i++) {
+          next_states.insert(state_dist(gen));
+        }
+        transition_function.emplace(NFA::situation_type{s, a},
+                                    std::move(next_states));
+      }
+      if (gen() % 10 == 0) {
+        epsilon_transition_function[s] = {state_dist(gen)};
+      }
+    }
+    return {std::move(states),         alphabet,
+            0,                         std::move(transition_function),
+            std::move(final_states),   std::move(epsilon_transition_function)};
+  }
+
+  //! Regex with about size operators over the given symbols
+  inline symbol_string random_regex(size_t size,
+                                    const std::vector<symbol_type> &symbols,
+                                    uint64_t seed = 0) {
+    std::mt19937_64 gen(seed);
+    auto random_symbol = [&]() { return symbols[gen() % symbols.size()]; };
+    auto generate = [&](auto &&self, size_t budget) -> symbol_string {
+      if (budget <= 1) {
+        return symbol_string(1, random_symbol());
+      }
+      auto left_budget = 1 + gen() % (budget - 1);
+      switch (gen() % 4) {
+      case 0:
+        return self(self, left_budget) + self(self, budget - left_budget);
+      case 1:
+        return U"(" + self(self, left_budget) + U"|" +
+               self(self, budget - left_budget) + U")";
+      case 2:
+        return U"(" + self(self, budget - 1) + U")*";
+      default:
+        return self(self, left_budget) + random_symbol() +
+               self(self, budget - left_budget);
+      }
+    };
+    return generate(generate, size);
+  }
+
+  //! String of uniformly random symbols
+  inline symbol_string random_string(size_t length,
+                                     const std::vector<symbol_type> &symbols,
+                                     uint64_t seed = 0) {
+    std::mt19937_64 gen(seed);
+    symbol_string str;
+    str.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+      str.push_back(symbols[gen() % symbols.size()]);
+    }
+    return str;
+  }
+
+  //! CFG with nonterminals N0...N{n-1} starting from N0, every nonterminal
+  //! has a terminal body so that all of them are productive
+  inline CFG::production_set_type
+  random_CFG_productions(size_t nonterminal_number, size_t body_number,
+                         const std::vector<symbol_type> &terminals,
+                         uint64_t seed = 0) {
+    std::mt19937_64 gen(seed);
+    auto nonterminal = [](size_t i) { return "N" + std::to_string(i); };
+    CFG::production_set_type productions;
+    for (size_t i = 0; i < nonterminal_number; i++) {
+      auto &bodies = productions[nonterminal(i)];
+      bodies.emplace(CFG_production::body_type{
+          grammar_symbol_type(terminals[gen() % terminals.size()])});
+      for (size_t j = 1; j < body_number; j++) {
+        CFG_production::body_type body;
+        auto const body_length = gen() % 4;
+        for (size_t k = 0; k < body_length; k++) {
+          if (gen() % 2 == 0) {
+            body.emplace_back(terminals[gen() % terminals.size()]);
+          } else {
+            body.emplace_back(nonterminal(gen() % nonterminal_number));
+          }
+        }
+        bodies.emplace(std::move(body));
+      }
+    }
+    return productions;
+  }
+
+  //! JSON over common tokens, strings and the literals are lexed as id
+  inline CFG::production_set_type get_JSON_productions() {
+    auto id = static_cast<CFG::terminal_type>(cyy::algorithm::common_token::id);
+    auto number =
+        static_cast<CFG::terminal_type>(cyy::algorithm::common_token::number);
+    CFG::production_set_type productions;
+    productions["Value"] = {{"Object"}, {"Array"}, {id}, {number}};
+    productions["Object"] = {{U'{', U'}'}, {U'{', "Members", U'}'}};
+    productions["Members"] = {{"Pair"}, {"Members", U',', "Pair"}};
+    productions["Pair"] = {{id, U':', "Value"}};
+    productions["Array"] = {{U'[', U']'}, {U'[', "Elements", U']'}};
+    productions["Elements"] = {{"Value"}, {"Elements", U',', "Value"}};
+    return productions;
+  }
+
+  //! Tokens of an expression of the grammar from get_expression_productions
+  //! with at least token_number tokens
+  inline symbol_string random_expression_tokens(size_t token_number,
+                                                uint64_t seed = 0) {
+    std::mt19937_64 gen(seed);
+    auto id = static_cast<symbol_type>(cyy::algorithm::common_token::id);
+    auto number =
+        static_cast<symbol_type>(cyy::algorithm::common_token::number);
+    symbol_string const operators = U"+-*/";
+    symbol_string tokens;
+    size_t depth = 0;
+    while (tokens.size() < token_number || depth != 0) {
+      if (tokens.size() < token_number && gen() % 4 == 0) {
+        tokens.push_back(U'(');
+        depth++;
+        continue;
+      }
+      tokens.push_back(gen() % 2 == 0 ? id : number);
+      while (depth != 0 && gen() % 3 == 0) {
+        tokens.push_back(U')');
+        depth--;
+      }
+      if (tokens.size() < token_number || depth != 0) {
+        tokens.push_back(operators[gen() % operators.size()]);
+      }
+    }
+    return tokens;
+  }
+
+  //! Tokens of a JSON array of nested objects with at least token_number
+  //! tokens
+  inline symbol_string random_JSON_tokens(size_t token_number,
+                                          uint64_t seed = 0) {
+    std::mt19937_64 gen(seed);
+    auto id = static_cast<symbol_type>(cyy::algorithm::common_token::id);
+    auto number =
+        static_cast<symbol_type>(cyy::algorithm::common_token::number);
+    symbol_string tokens = U"[";
+    while (tokens.size() < token_number) {
+      if (tokens.size() > 1) {
+        tokens.push_back(U',');
+      }
+      tokens += {U'{', id, U':', number, U',', id, U':', U'['};
+      auto const element_number = gen() % 4;
+      for (size_t i = 0; i < element_number; i++) {
+        if (i != 0) {
+          tokens.push_back(U',');
+        }
+        tokens.push_back(gen() % 2 == 0 ? id : number);
+      }
+      tokens += {U']', U'}'};
+    }
+    tokens.push_back(U']');
+    return tokens;
+  }
+} // namespace cyy::computation::benchmark
@@ -0,0 +1,13 @@
+/*!
+ * \file lalr_performance_fuzzing.cpp
+ *
+ * \brief flag LALR inputs whose cost grows faster than expected
+ */
+
+#include "../performance_helper.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size);
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
+  return performance_fuzzing::check_cost(performance_fuzzing::LALR_workload,
+                                         Data, Size);
+}
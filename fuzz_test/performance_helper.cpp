@@ -0,0 +1,104 @@
+/*!
+ * \file performance_helper.cpp
+ *
+ * \brief cost measurement of performance fuzzing targets
+ */
+
+#include "performance_helper.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+#include "instrumentation.hpp"
+
+namespace {
+  thread_local uint64_t allocation_count{0};
+} // namespace
+
+void *operator new(std::size_t size) {
+  allocation_count++;
+  if (auto *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace performance_fuzzing {
+  namespace {
+    uint64_t get_operation_count() {
+      using cyy::computation::instrumentation::counter;
+      auto const counters =
+          cyy::computation::instrumentation::get_thread_counters();
+      uint64_t count = 0;
+      for (size_t i = 0; i < counters.values.size(); i++) {
+        auto const c = static_cast<counter>(i);
+        if (c != counter::LR_1_collection_ns && c != counter::LR_1_table_ns) {
+          count += counters[c];
+        }
+      }
+      return count;
+    }
+
+    std::filesystem::path get_corpus_dir(const workload &w) {
+      std::filesystem::path dir = PERFORMANCE_CORPUS_DIR;
+      if (auto const *env_dir = std::getenv("PERFORMANCE_CORPUS_DIR")) {
+        dir = env_dir;
+      }
+      return dir / w.name;
+    }
+
+    void save_input(const workload &w, const uint8_t *Data, size_t Size) {
+      auto const dir = get_corpus_dir(w);
+      std::error_code ec;
+      std::filesystem::create_directories(dir, ec);
+      if (ec) {
+        return;
+      }
+      auto const hash = std::hash<std::string_view>()(
+          std::string_view(reinterpret_cast<const char *>(Data), Size));
+      std::ofstream os(dir / std::format("{:016x}", hash), std::ios::binary);
+      os.write(reinterpret_cast<const char *>(Data),
+               static_cast<std::streamsize>(Size));
+    }
+  } // namespace
+
+  cost_type measure_cost(const workload &w, const uint8_t *Data, size_t Size) {
+    auto const begin_operations = get_operation_count();
+    auto const begin_allocations = allocation_count;
+    w.run(Data, Size);
+    return {.operations = get_operation_count() - begin_operations,
+            .allocations = allocation_count - begin_allocations};
+  }
+
+  int check_cost(const workload &w, const uint8_t *Data, size_t Size) {
+    // short inputs are dominated by constant overhead
+    constexpr size_t min_size = 16;
+    static double worst_cost_per_byte = 0;
+
+    auto const cost = measure_cost(w, Data, Size);
+    auto const size = static_cast<double>(std::max(Size, min_size));
+    auto const cost_per_byte = static_cast<double>(cost.total()) / size;
+    if (Size >= min_size && cost_per_byte > worst_cost_per_byte) {
+      worst_cost_per_byte = cost_per_byte;
+      save_input(w, Data, Size);
+      std::cerr << std::format(
+          "{{\"workload\":\"{}\",\"size\":{},\"operations\":{},"
+          "\"allocations\":{},\"cost_per_byte\":{}}}\n",
+          w.name, Size, cost.operations, cost.allocations, cost_per_byte);
+    }
+    if (static_cast<double>(cost.total()) >
+        w.coefficient * std::pow(size, w.exponent)) {
+      std::cerr << std::format("{} input of {} bytes costs {}, over budget\n",
+                               w.name, Size, cost.total());
+      std::abort();
+    }
+    return 0;
+  }
+} // namespace performance_fuzzing
@@ -0,0 +1,24 @@
+/*!
+ * \file performance_helper.hpp
+ *
+ * \brief cost measurement of performance fuzzing targets
+ */
+#pragma once
+
+#include "performance_workload.hpp"
+
+namespace performance_fuzzing {
+  struct cost_type {
+    //! sum of the instrumentation counters, excluding timers
+    uint64_t operations{0};
+    uint64_t allocations{0};
+    uint64_t total() const noexcept { return operations + allocations; }
+  };
+
+  cost_type measure_cost(const workload &w, const uint8_t *Data, size_t Size);
+
+  //! Run the workload, save inputs with the highest cost per byte so far to
+  //! the corpus directory of the build tree and abort if the cost exceeds the
+  //! budget
+  int check_cost(const workload &w, const uint8_t *Data, size_t Size);
+} // namespace performance_fuzzing
@@ -0,0 +1,93 @@
+/*!
+ * \file performance_workload.hpp
+ *
+ * \brief workloads of the performance fuzzing targets, shared with the
+ * benchmark that replays their regression corpus
+ */
+#pragma once
+
+#include <array>
+#include <string_view>
+
+#include "context_free_lang/cnf.hpp"
+#include "context_free_lang/lalr_grammar.hpp"
+#include "helper.hpp"
+#include "regular_lang/regex.hpp"
+
+namespace performance_fuzzing {
+  using namespace cyy::computation;
+
+  //! The cost of an input of n bytes is expected to stay below
+  //! coefficient * n^exponent
+  struct workload {
+    std::string_view name;
+    void (*run)(const uint8_t *Data, size_t Size);
+    double coefficient;
+    double exponent;
+  };
+
+  //! Parse the first half as a regex and recognize the second half
+  inline void run_regex(const uint8_t *Data, size_t Size) {
+    auto part_size = Size / 2;
+    auto expr = fuzzing_symbol_string(Data, part_size);
+    auto str = fuzzing_symbol_string(Data + part_size, Size - part_size);
+    try {
+      regex const reg("printable-ASCII", expr);
+      static_cast<void>(reg.to_DFA().recognize(str));
+      static_cast<void>(reg.to_NFA().recognize(str));
+    } catch (const std::invalid_argument &) {
+    }
+  }
+
+  inline void run_NFA(const uint8_t *Data, size_t Size) {
+    auto part_size = Size / 2;
+    auto str = fuzzing_symbol_string(Data + part_size, Size - part_size);
+    try {
+      auto const nfa = fuzzing_NFA(Data, part_size);
+      static_cast<void>(nfa.recognize(str));
+      static_cast<void>(nfa.to_DFA());
+    } catch (const std::invalid_argument &) {
+    }
+  }
+
+  inline void run_CNF(const uint8_t *Data, size_t Size) {
+    auto part_size = Size / 2;
+    auto productions = fuzzing_CFG_productions(Data, part_size);
+    if (productions.empty()) {
+      return;
+    }
+    auto start_symbol = productions.begin()->first;
+    auto str = fuzzing_symbol_string(Data + part_size, Size - part_size);
+    try {
+      CFG cfg("common_tokens", start_symbol, productions);
+      cfg.to_CNF();
+      CNF const cnf(std::move(cfg));
+      static_cast<void>(cnf.parse(str));
+    } catch (const std::invalid_argument &) {
+    }
+  }
+
+  inline void run_LALR(const uint8_t *Data, size_t Size) {
+    auto part_size = Size / 2;
+    auto productions = fuzzing_CFG_productions(Data, part_size);
+    if (productions.empty()) {
+      return;
+    }
+    auto start_symbol = productions.begin()->first;
+    auto str = fuzzing_symbol_string(Data + part_size, Size - part_size);
+    try {
+      LALR_grammar grammar("common_tokens", start_symbol, productions);
+      static_cast<void>(grammar.parse(str, [](auto) {}, [](auto &) {}));
+    } catch (const std::invalid_argument &) {
+    }
+  }
+
+  // Subset construction and LR(1) collections may legitimately be
+  // exponential, the budgets flag inputs far above typical grammars.
+  inline constexpr workload regex_workload{"regex", run_regex, 256, 2};
+  inline constexpr workload NFA_workload{"NFA", run_NFA, 256, 2};
+  inline constexpr workload CNF_workload{"CNF", run_CNF, 64, 3};
+  inline constexpr workload LALR_workload{"LALR", run_LALR, 256, 3};
+  inline constexpr std::array workloads{regex_workload, NFA_workload,
+                                        CNF_workload, LALR_workload};
+} // namespace performance_fuzzing
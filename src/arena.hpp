@@ -0,0 +1,45 @@
+/*!
+ * \file arena.hpp
+ *
+ * \brief scratch memory for automaton construction
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+
+namespace cyy::computation {
+  inline std::pmr::memory_resource *&current_scratch_resource() noexcept {
+    thread_local std::pmr::memory_resource *resource = nullptr;
+    return resource;
+  }
+
+  //! Temporaries of subset construction and regex::to_DFA are allocated from
+  //! this resource, the constructed automata use the default allocator.
+  inline std::pmr::memory_resource *get_scratch_resource() noexcept {
+    auto *resource = current_scratch_resource();
+    return resource != nullptr ? resource : std::pmr::get_default_resource();
+  }
+
+  //! While alive, scratch memory of the current thread comes from a
+  //! monotonic buffer that is released at once when the scope ends.
+  class arena_scope {
+  public:
+    explicit arena_scope(size_t initial_size = 64 * 1024)
+        : buffer(initial_size),
+          previous(std::exchange(current_scratch_resource(), &buffer)) {}
+    arena_scope(const arena_scope &) = delete;
+    arena_scope &operator=(const arena_scope &) = delete;
+    arena_scope(arena_scope &&) = delete;
+    arena_scope &operator=(arena_scope &&) = delete;
+    ~arena_scope() { current_scratch_resource() = previous; }
+
+    std::pmr::memory_resource *get_resource() noexcept { return &buffer; }
+
+  private:
+    std::pmr::monotonic_buffer_resource buffer;
+    std::pmr::memory_resource *previous;
+  };
+} // namespace cyy::computation
@@ -48,8 +48,7 @@ namespace cyy::computation {
   bool
   finite_automaton::state_bitset_contains(const state_bitset_type &state_bitset,
                                           state_type state) const {
-    return state_bitset.test(
-        static_cast<size_t>(std::distance(states.begin(), states.find(state))));
+    return state_bitset.test(get_state_index(state));
   }
 
   std::string finite_automaton::MMA_draw() const {
@@ -137,6 +137,11 @@ namespace cyy::computation {
     [[nodiscard]] bool has_state(state_type s) const {
       return states.contains(s);
     }
+    //! Position of the state in the ordered state set
+    [[nodiscard]] size_t get_state_index(state_type s) const {
+      return static_cast<size_t>(
+          std::distance(states.begin(), states.find(s)));
+    }
     void check_state(state_type s) const {
       if (!has_state(s)) {
         throw cyy::computation::exception::no_finite_automaton(
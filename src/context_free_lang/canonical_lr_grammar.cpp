@@ -105,8 +105,8 @@ namespace cyy::computation {
 
   std::pair<canonical_LR_grammar::collection_type,
             canonical_LR_grammar::goto_table_type>
-  canonical_LR_grammar::get_collection() const {
-    DK_1_DFA const dk_1_dfa(*this);
+  canonical_LR_grammar::get_collection(const CFG &cfg) const {
+    DK_1_DFA const dk_1_dfa(cfg);
     return {dk_1_dfa.get_LR_1_item_set_collection(), dk_1_dfa.get_goto_table()};
   }
 
@@ -16,8 +16,10 @@ namespace cyy::computation {
 
   public:
     using LR_1_grammar::LR_1_grammar;
+    using LR_1_grammar::get_collection;
 
-    std::pair<collection_type, goto_table_type> get_collection() const override;
+    std::pair<collection_type, goto_table_type>
+    get_collection(const CFG &cfg) const override;
     DPDA to_DPDA() const;
   };
 } // namespace cyy::computation
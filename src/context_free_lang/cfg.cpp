@@ -17,6 +17,7 @@
 #include <cyy/algorithm/alphabet/union_alphabet.hpp>
 
 #include "exception.hpp"
+#include "instrumentation.hpp"
 
 namespace cyy::computation {
   using namespace cyy::algorithm;
@@ -50,6 +51,12 @@ namespace cyy::computation {
     }
   }
 
+  bool CFG::operator==(const CFG &rhs) const {
+    return alphabet == rhs.alphabet && start_symbol == rhs.start_symbol &&
+           old_start_symbol == rhs.old_start_symbol &&
+           productions == rhs.productions;
+  }
+
   std::ostream &operator<<(std::ostream &os, const CFG &cfg) {
     // by convention,we print start symbol first.
     for (size_t i = 0; i < 2; i++) {
@@ -108,7 +115,29 @@ namespace cyy::computation {
   void CFG::normalize_productions() {
     std::erase_if(productions,
                   [](const auto &bodyes) { return bodyes.second.empty(); });
-    first_sets.clear();
+    clear_caches();
+  }
+
+  void CFG::clear_caches() {
+    first_sets.reset();
+    interned.reset();
+    analysis.reset();
+  }
+
+  const interned_grammar &CFG::get_interned_grammar() const {
+    return interned.get(
+        [this] { return interned_grammar(start_symbol, productions); });
+  }
+
+  std::shared_ptr<const interned_grammar>
+  CFG::get_shared_interned_grammar() const {
+    return interned.get_shared(
+        [this] { return interned_grammar(start_symbol, productions); });
+  }
+
+  const grammar_analysis &CFG::get_grammar_analysis() const {
+    return analysis.get(
+        [this] { return grammar_analysis(get_interned_grammar()); });
   }
 
   void CFG::eliminate_useless_symbols() {
@@ -204,6 +233,7 @@ namespace cyy::computation {
         return body.size() == 1 && body[0] == real_head;
       });
     }
+    clear_caches();
   }
   bool CFG::has_left_recursion() const {
     auto head_dependency = get_head_dependency();
@@ -345,132 +375,59 @@ namespace cyy::computation {
     normalize_productions();
   }
 
-  const std::unordered_map<CFG::nonterminal_type,
-                           std::pair<CFG::terminal_set_type, bool>> &
-  CFG::first() const {
-
-    if (!first_sets.empty()) {
-      return first_sets;
-    }
-
-    // process all terminals
-    for (auto const &[head, bodies] : productions) {
-      for (auto const &body : bodies) {
-        auto &[first_set, epsilon_in_first] = first_sets[head];
-        if (body.empty()) {
-          epsilon_in_first = true;
-        } else if (body[0].is_terminal()) {
-          first_set.insert(body[0].get_terminal());
-        }
-      }
+  const CFG::first_set_map_type &CFG::first() const {
+    if (first_sets.has_value()) {
+      instrumentation::add(instrumentation::counter::first_set_cache_hit);
+    } else {
+      instrumentation::add(instrumentation::counter::first_set_cache_miss);
     }
-
-    bool add_new_terminal = true;
-    while (add_new_terminal) {
-
-      add_new_terminal = false;
-
-      for (auto const &[head, bodies] : productions) {
-        auto &[first_set, epsilon_in_first] = first_sets[head];
-        for (auto const &body : bodies) {
-          size_t i = 0;
-          for (; i < body.size(); i++) {
-            if (body[i].is_terminal()) {
-              if (first_set.insert(body[i].get_terminal()).second) {
-                add_new_terminal = true;
-              }
-              break;
-            }
-
-            auto const &nonterminal = body[i].get_nonterminal();
-
-            for (auto const &first_terminal : first_sets[nonterminal].first) {
-              if (first_set.insert(first_terminal).second) {
-                add_new_terminal = true;
-              }
-            }
-            if (!first_sets[nonterminal].second) {
-              break;
-            }
-          }
-          if (i == body.size()) {
-            if (!epsilon_in_first) {
-              epsilon_in_first = true;
-              add_new_terminal = true;
-            }
-          }
-        }
+    return first_sets.get([this] {
+      auto const &grammar = get_interned_grammar();
+      auto const &grammar_sets = get_grammar_analysis();
+      first_set_map_type result;
+      for (nonterminal_id_type id = 0; id < grammar.get_nonterminal_number();
+           id++) {
+        result.emplace(
+            grammar.get_name(id),
+            std::pair{grammar_sets.to_terminal_set(grammar_sets.get_first(id)),
+                      grammar_sets.is_nullable(id)});
       }
-    }
-
-    return first_sets;
+      return result;
+    });
   }
 
   std::pair<CFG::terminal_set_type, bool>
   CFG::first(const grammar_symbol_const_span_type &alpha) const {
-    if (alpha.empty()) {
-      return {{}, true};
-    }
-
-    first();
-    terminal_set_type view_first_set;
+    auto const &grammar = get_interned_grammar();
+    auto const &grammar_sets = get_grammar_analysis();
+    grammar_analysis::terminal_bitset_type first_bitset(
+        grammar_sets.get_terminal_number());
     for (auto const &symbol : alpha) {
       if (symbol.is_terminal()) {
-        view_first_set.insert(symbol.get_terminal());
-        return {view_first_set, false};
+        auto first_set = grammar_sets.to_terminal_set(first_bitset);
+        first_set.insert(symbol.get_terminal());
+        return {std::move(first_set), false};
       }
-      const auto &nonterminal = *symbol.get_nonterminal_ptr();
-
-      auto it = first_sets.find(nonterminal);
-      assert(it != first_sets.end());
-      auto [first_set, epsilon_in_first] = it->second;
-      view_first_set.merge(first_set);
-      if (!epsilon_in_first) {
-        return {view_first_set, false};
+      auto id = grammar.get_id(symbol.get_nonterminal());
+      assert(id.has_value());
+      first_bitset |= grammar_sets.get_first(*id);
+      if (!grammar_sets.is_nullable(*id)) {
+        return {grammar_sets.to_terminal_set(first_bitset), false};
       }
     }
-    return {view_first_set, true};
+    return {grammar_sets.to_terminal_set(first_bitset), true};
   }
 
   std::unordered_map<CFG::nonterminal_type, CFG::terminal_set_type>
   CFG::follow() const {
+    auto const &grammar = get_interned_grammar();
+    auto const &grammar_sets = get_grammar_analysis();
     std::unordered_map<nonterminal_type, terminal_set_type> follow_sets;
-
-    follow_sets[start_symbol].insert(ALPHABET::endmarker);
-
-    bool has_add = false;
-    do {
-      has_add = false;
-      for (const auto &[head, bodies] : productions) {
-        for (const auto &body : bodies) {
-          for (size_t i = 0; i < body.size(); i++) {
-            if (body[i].is_terminal()) {
-              continue;
-            }
-
-            auto const &[first_set, epsilon_in_first] =
-                first(grammar_symbol_const_span_type(body).subspan(i + 1));
-
-            const auto &nonterminal = *(body[i].get_nonterminal_ptr());
-            auto &follow_set = follow_sets[nonterminal];
-            for (auto const &terminal : first_set) {
-              if (follow_set.insert(terminal).second) {
-                has_add = true;
-              }
-            }
-
-            if (epsilon_in_first) {
-              for (auto const &terminal : follow_sets[head]) {
-                if (follow_set.insert(terminal).second) {
-                  has_add = true;
-                }
-              }
-            }
-          }
-        }
-      }
-    } while (has_add);
-
+    for (nonterminal_id_type id = 0; id < grammar.get_nonterminal_number();
+         id++) {
+      follow_sets.emplace(grammar.get_name(id),
+                          grammar_sets.to_terminal_set(grammar_sets.get_follow(id)));
+    }
     return follow_sets;
   }
 
@@ -516,9 +473,16 @@ namespace cyy::computation {
     start_symbol = get_new_head(start_symbol);
     productions[start_symbol].emplace(
         CFG_production::body_type{old_start_symbol});
+    clear_caches();
+  }
+  CFG CFG::get_augmented_grammar() const {
+    CFG cfg(*this);
+    cfg.normalize_start_symbol();
+    return cfg;
   }
   void CFG::remove_head(const nonterminal_type &head) {
     productions.erase(head);
+    clear_caches();
     if (head == start_symbol) {
       if (old_start_symbol.empty()) {
         throw exception::no_CFG("no productions for start symbol");
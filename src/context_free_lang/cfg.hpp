@@ -12,6 +12,9 @@
 
 #include "cfg_production.hpp"
 #include "formal_grammar/grammar_symbol.hpp"
+#include "grammar_analysis.hpp"
+#include "interned_grammar.hpp"
+#include "once_cache.hpp"
 
 namespace cyy::computation {
 
@@ -60,7 +63,8 @@ namespace cyy::computation {
 
     virtual ~CFG() = default;
 
-    bool operator==(const CFG &rhs) const = default;
+    //! Caches are not compared
+    bool operator==(const CFG &rhs) const;
 
     bool has_production(const CFG_production &production) const;
 
@@ -93,15 +97,25 @@ namespace cyy::computation {
     const production_body_set_type &
     get_bodies(const nonterminal_type &head) const;
 
+    //! The productions with interned nonterminals, rebuilt after mutation
+    const interned_grammar &get_interned_grammar() const;
+    //! Shares the interned grammar with objects that outlive its cache
+    std::shared_ptr<const interned_grammar>
+    get_shared_interned_grammar() const;
+    //! nullable, FIRST and FOLLOW over the interned grammar, rebuilt after
+    //! mutation
+    const grammar_analysis &get_grammar_analysis() const;
+
     terminal_set_type get_terminals() const;
     nonterminal_set_type get_nonterminals() const;
 
     bool has_left_recursion() const;
     void eliminate_left_recursion(std::vector<nonterminal_type> old_heads = {});
 
-    const std::unordered_map<nonterminal_type,
-                             std::pair<terminal_set_type, bool>> &
-    first() const;
+    using first_set_map_type =
+        std::unordered_map<nonterminal_type,
+                           std::pair<terminal_set_type, bool>>;
+    const first_set_map_type &first() const;
 
     std::pair<terminal_set_type, bool>
     first(const grammar_symbol_const_span_type &alpha) const;
@@ -111,6 +125,7 @@ namespace cyy::computation {
 
     void left_factoring();
 
+    //! Memoized recursive descent, left recursion included
     bool recursive_descent_parse(symbol_string_view view) const;
 
     std::unordered_map<nonterminal_type, terminal_set_type> follow() const;
@@ -143,6 +158,9 @@ namespace cyy::computation {
 
   protected:
     void normalize_start_symbol();
+    //! A copy with a new start symbol whose only body is the start symbol,
+    //! so parsing tables are built without modifying this grammar
+    CFG get_augmented_grammar() const;
 
     static nonterminal_type get_new_head(nonterminal_type advise_head,
                                          const nonterminal_set_type &heads) {
@@ -157,6 +175,8 @@ namespace cyy::computation {
   private:
     std::unordered_map<nonterminal_type, nonterminal_set_type>
     get_head_dependency() const;
+    //! Called whenever productions or the start symbol change
+    void clear_caches();
 
   protected:
     ALPHABET_ptr alphabet;
@@ -165,9 +185,9 @@ namespace cyy::computation {
     nonterminal_type start_symbol;
     nonterminal_type old_start_symbol;
     production_set_type productions;
-    mutable std::unordered_map<nonterminal_type,
-                               std::pair<terminal_set_type, bool>>
-        first_sets;
+    once_cache<first_set_map_type> first_sets;
+    once_cache<interned_grammar> interned;
+    once_cache<grammar_analysis> analysis;
   };
 
 } // namespace cyy::computation
@@ -6,194 +6,147 @@
  */
 
 #include <algorithm>
-#include <cassert>
-#include <ranges>
-#include <stack>
+#include <cstdint>
+#include <flat_set>
+#include <limits>
+#include <unordered_map>
 
-#include <cyy/algorithm/hash.hpp>
-#include "../exception.hpp"
 #include "cfg.hpp"
 
 namespace cyy::computation {
   namespace {
 
-    class recursive_descent_parse_node;
-    using recursive_descent_parse_node_ptr =
-        std::shared_ptr<recursive_descent_parse_node>;
-    class recursive_descent_parse_node {
+    //! Recursive descent that memoizes all the end offsets of a nonterminal
+    //! from an offset (packrat parsing without ordered choice). A call that
+    //! reaches an entry still being computed gets its current ends as a
+    //! seed; the outermost entry of such a recursion cycle grows the seeds
+    //! of the cycle until no entry changes.
+    class memoized_descent_parser {
     public:
-      using iter_type = CFG::production_set_type::mapped_type::const_iterator;
+      using end_set_type = std::flat_set<size_t>;
 
-      recursive_descent_parse_node(const CFG &cfg_,
-                                   grammar_symbol_type grammar_symbol_)
-          : grammar_symbol(std::move(grammar_symbol_)), cfg(cfg_) {
-        if (grammar_symbol.is_nonterminal()) {
-          auto const &bodies = cfg.get_bodies(grammar_symbol.get_nonterminal());
-          begin_body_it_opt = bodies.begin();
-          end_body_it_opt = bodies.end();
-          reset_iter();
-        }
+      memoized_descent_parser(const interned_grammar &grammar_,
+                              cyy::algorithm::symbol_string_view view_)
+          : grammar(grammar_), view(view_) {}
+
+      bool parse() {
+        size_t low_depth = no_cycle;
+        return match(interned_grammar::start_symbol, 0, low_depth)
+            .contains(view.size());
       }
 
-      bool use_next_body() {
-        if (cur_body_it_opt == end_body_it_opt) {
-          return false;
+    private:
+      static constexpr size_t no_cycle = std::numeric_limits<size_t>::max();
+      struct entry_type {
+        end_set_type ends;
+        //! position on the stack while not complete
+        size_t depth{0};
+        //! the lowest depth of the unfinished entries this entry used
+        size_t low_depth{no_cycle};
+        size_t generation{0};
+        bool in_progress{false};
+        bool complete{false};
+      };
+
+      const end_set_type &match(nonterminal_id_type nonterminal, size_t begin,
+                                size_t &low_depth) {
+        auto const key =
+            static_cast<uint64_t>(nonterminal) * (view.size() + 1) + begin;
+        auto [it, has_emplaced] = memo.try_emplace(key);
+        auto &entry = it->second;
+        if (!has_emplaced) {
+          if (entry.complete) {
+            return entry.ends;
+          }
+          if (entry.in_progress) {
+            low_depth = std::min(low_depth, entry.depth);
+            return entry.ends;
+          }
+          // computed earlier in this round of growing
+          if (entry.generation == generation) {
+            low_depth = std::min(low_depth, entry.low_depth);
+            return entry.ends;
+          }
         }
-        if (!children.empty()) {
-          for (auto it = children.rbegin(); it != children.rend(); ++it) {
-            if ((*it)->use_next_body()) {
-              for (auto it2 = children.rbegin(); it2 < it; ++it2) {
-                (*it2)->reset_iter();
-              }
-              return true;
+
+        entry.in_progress = true;
+        entry.depth = stack.size();
+        stack.push_back(key);
+        while (true) {
+          auto const old_change_number = change_number;
+          entry.low_depth = no_cycle;
+          for (auto const index : grammar.get_production_indices(nonterminal)) {
+            auto ends = match_body(grammar.get_production(index).body, begin,
+                                   entry.low_depth);
+            auto const old_size = entry.ends.size();
+            entry.ends.insert(ends.begin(), ends.end());
+            if (entry.ends.size() != old_size) {
+              change_number++;
             }
           }
+          // either no cycle or a cycle finished by an entry below
+          if (entry.low_depth == no_cycle || entry.low_depth < entry.depth ||
+              change_number == old_change_number) {
+            break;
+          }
+          generation++;
         }
-        return use_next_body_of_root();
-      }
-      bool use_next_body_of_root() {
-        if (cur_body_it_opt == end_body_it_opt) {
-          return false;
+        entry.in_progress = false;
+        entry.generation = generation;
+        if (entry.low_depth < entry.depth) {
+          low_depth = std::min(low_depth, entry.low_depth);
+          return entry.ends;
         }
-        assert(grammar_symbol.is_nonterminal());
-        cur_body_it_opt = ++(*cur_body_it_opt);
-        children.clear();
-        if (cur_body_it_opt != end_body_it_opt) {
-          set_children();
-          return true;
+        // the entries above belong to the cycle of this entry
+        while (true) {
+          auto const top = stack.back();
+          stack.pop_back();
+          memo[top].complete = true;
+          if (top == key) {
+            break;
+          }
         }
-        return false;
+        return entry.ends;
       }
 
-      std::pair<bool, cyy::algorithm::symbol_string_view>
-      match_nonterminal(cyy::algorithm::symbol_string_view view,
-                        bool match_all = false) {
-        assert(cur_body_it_opt);
-        assert(end_body_it_opt);
-        while (cur_body_it_opt != end_body_it_opt) {
-          auto const &body = *(*cur_body_it_opt);
-          if (body.empty()) {
-            if (match_all) {
-              if (view.empty()) {
-                return {true, view};
+      end_set_type
+      match_body(const std::vector<interned_symbol_type> &body, size_t begin,
+                 size_t &low_depth) {
+        end_set_type positions{begin};
+        for (auto const &symbol : body) {
+          end_set_type next_positions;
+          for (auto const position : positions) {
+            if (symbol.is_terminal()) {
+              if (position < view.size() &&
+                  view[position] == symbol.get_terminal()) {
+                next_positions.insert(position + 1);
               }
-              use_next_body_of_root();
               continue;
             }
-            return {true, view};
+            auto const &ends =
+                match(symbol.get_nonterminal(), position, low_depth);
+            next_positions.insert(ends.begin(), ends.end());
           }
-
-          if (static_cast<std::size_t>(std::ranges::count_if(
-                  body, [](auto const &g) { return g.is_terminal(); })) >
-              view.size()) {
-            use_next_body_of_root();
-            continue;
-          }
-
-          std::stack<cyy::algorithm::symbol_string_view> view_stack;
-          view_stack.push(view);
-          std::size_t i = 0;
-          bool backtrack_succ = true;
-          while (i < body.size()) {
-            assert(view_stack.size() == i + 1);
-            auto cur_view = view_stack.top();
-            auto const &grammal_symbol = body[i];
-            if (grammal_symbol.is_terminal()) {
-              if (!cur_view.empty() &&
-                  grammal_symbol.get_terminal() == cur_view[0]) {
-                cur_view.remove_prefix(1);
-                view_stack.push(cur_view);
-                i++;
-                continue;
-              }
-            } else {
-              auto [result, remain_view] =
-                  children[i]->match_nonterminal(cur_view);
-              if (result) {
-                view_stack.push(remain_view);
-                i++;
-                continue;
-              }
-            }
-            // backtrack
-            backtrack_succ = false;
-            while (true) {
-              if (children[i]->use_next_body()) {
-                backtrack_succ = true;
-                for (auto j = i + 1; j < children.size(); j++) {
-                  children[j]->reset_iter();
-                }
-                break;
-              }
-              if (i == 0) {
-                break;
-              }
-              view_stack.pop();
-              i--;
-            }
-            if (!backtrack_succ) {
-              use_next_body_of_root();
-              break;
-            }
-          }
-          if (backtrack_succ) {
-            return {true, view_stack.top()};
+          if (next_positions.empty()) {
+            return next_positions;
           }
+          positions = std::move(next_positions);
         }
-        return {false, view};
+        return positions;
       }
 
-    private:
-      grammar_symbol_type grammar_symbol;
-      std::vector<recursive_descent_parse_node_ptr> children;
-      const CFG &cfg;
-      std::optional<iter_type> begin_body_it_opt;
-      std::optional<iter_type> cur_body_it_opt;
-      std::optional<iter_type> end_body_it_opt;
-
-      void reset_iter() {
-        if (grammar_symbol.is_nonterminal()) {
-          cur_body_it_opt = begin_body_it_opt;
-          set_children();
-        }
-      }
-      void set_children() {
-        assert(cur_body_it_opt != end_body_it_opt);
-        auto const &body = *(*cur_body_it_opt);
-        children = body | std::views::transform([this](auto const &s) {
-                     return std::make_shared<recursive_descent_parse_node>(cfg, s);
-                   }) |
-                   std::ranges::to<std::vector<recursive_descent_parse_node_ptr>>();
-      }
+      const interned_grammar &grammar;
+      cyy::algorithm::symbol_string_view view;
+      std::unordered_map<uint64_t, entry_type> memo;
+      std::vector<uint64_t> stack;
+      size_t change_number{0};
+      size_t generation{1};
     };
 
   } // namespace
 
   bool CFG::recursive_descent_parse(symbol_string_view view) const {
-    if (has_left_recursion()) {
-      throw exception::left_recursion_CFG("");
-    }
-    auto terminals = get_terminals();
-    for (auto s : view) {
-      if (!terminals.contains(s)) {
-        return false;
-      }
-    }
-    recursive_descent_parse_node node(*this, start_symbol);
-    while (true) {
-      auto [res, remain_view] = node.match_nonterminal(view, true);
-      if (!res) {
-        return false;
-      }
-      if (remain_view.empty()) {
-        return true;
-      }
-
-      if (!node.use_next_body()) {
-        break;
-      }
-    }
-    return false;
+    return memoized_descent_parser(get_interned_grammar(), view).parse();
   }
 
 } // namespace cyy::computation
@@ -6,8 +6,12 @@
 #include "cnf.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <thread>
 
-#include <cyy/algorithm/hash.hpp>
+#include "instrumentation.hpp"
 
 namespace cyy::computation {
   bool CNF::valid() const {
@@ -39,43 +43,157 @@ namespace cyy::computation {
     return true;
   }
   bool CNF::parse(symbol_string_view view) const {
-    make_reverse_productions();
+    instrumentation::add(instrumentation::counter::CNF_parse);
+    auto const &rules = CYK_rules.get([this] { return make_CYK_rules(); });
     if (view.empty()) {
-      return reverse_productions[{}].contains(get_start_symbol());
+      return rules.start_symbol_nullable;
     }
-    std::vector<std::vector<std::unordered_set<nonterminal_type>>> table(
-        view.size());
+    auto const n = view.size();
+    CYK_table table(n, rules.word_number);
+    if (!fill_terminal_cells(rules, view, table)) {
+      return false;
+    }
+    for (size_t len = 2; len <= n; len++) {
+      fill_cells(rules, table, len, 0, n - len + 1);
+    }
+    return (table.get_cell(n, 0)[0] & 1) != 0;
+  }
+
+  bool CNF::parallel_parse(symbol_string_view view, size_t thread_number,
+                           size_t grain_size) const {
+    if (thread_number == 0) {
+      thread_number = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (thread_number == 1 || view.size() < 2) {
+      return parse(view);
+    }
+    instrumentation::add(instrumentation::counter::CNF_parse);
+    auto const &rules = CYK_rules.get([this] { return make_CYK_rules(); });
+    auto const n = view.size();
+    CYK_table table(n, rules.word_number);
+    if (!fill_terminal_cells(rules, view, table)) {
+      return false;
+    }
+    grain_size = std::max<size_t>(grain_size, 1);
+
+    // Cells of the same span length only depend on shorter spans, so the
+    // threads share each diagonal and meet at a barrier before the next one.
+    size_t len = 2;
+    std::atomic_size_t next_begin{0};
+    std::barrier sync(static_cast<std::ptrdiff_t>(thread_number),
+                      [&]() noexcept {
+                        len++;
+                        next_begin = 0;
+                      });
+    auto worker = [&]() {
+      while (len <= n) {
+        auto const cell_number = n - len + 1;
+        while (true) {
+          auto const begin = next_begin.fetch_add(grain_size);
+          if (begin >= cell_number) {
+            break;
+          }
+          fill_cells(rules, table, len, begin,
+                     std::min(begin + grain_size, cell_number));
+        }
+        sync.arrive_and_wait();
+      }
+    };
+    {
+      std::vector<std::jthread> threads;
+      for (size_t i = 1; i < thread_number; i++) {
+        threads.emplace_back(worker);
+      }
+      worker();
+    }
+    return (table.get_cell(n, 0)[0] & 1) != 0;
+  }
+
+  CNF::CYK_table::CYK_table(size_t input_length, size_t word_number_)
+      : word_number(word_number_), diagonal_offsets(input_length + 1, 0) {
+    for (size_t len = 1; len < input_length; len++) {
+      diagonal_offsets[len + 1] =
+          diagonal_offsets[len] + (input_length - len + 1);
+    }
+    cells.resize((diagonal_offsets[input_length] + 1) * word_number, 0);
+  }
+
+  bool CNF::fill_terminal_cells(const CYK_rules_type &rules,
+                                symbol_string_view view, CYK_table &table) {
     for (size_t i = 0; i < view.size(); i++) {
-      table[i].resize(view.size());
-      table[i][i] = reverse_productions[{view[i]}];
+      auto it = rules.terminal_heads.find(view[i]);
+      if (it == rules.terminal_heads.end()) {
+        return false;
+      }
+      std::ranges::copy(it->second, table.get_cell(1, i));
     }
+    return true;
+  }
 
-    for (size_t len = 2; len <= view.size(); len++) {
-      for (size_t i = 0; i + len - 1 < view.size(); i++) {
-        const auto j = i + len - 1;
-        for (size_t k = i; k < j; k++) {
-          auto const &first_heads = table[i][k];
-          auto const &second_heads = table[k + 1][j];
-          for (auto const &A : first_heads) {
-            for (auto const &B : second_heads) {
-              table[i][j].merge(std::unordered_set<nonterminal_type>(
-                  reverse_productions[{A, B}]));
+  void CNF::fill_cells(const CYK_rules_type &rules, CYK_table &table,
+                       size_t span_length, size_t begin, size_t end) {
+    auto const word_number = rules.word_number;
+    // Each split streams over three contiguous diagonals.
+    for (size_t left_len = 1; left_len < span_length; left_len++) {
+      auto const right_len = span_length - left_len;
+      for (size_t i = begin; i < end; i++) {
+        auto const *left = table.get_cell(left_len, i);
+        auto const *right = table.get_cell(right_len, i + left_len);
+        auto *result = table.get_cell(span_length, i);
+        for (size_t w = 0; w < word_number; w++) {
+          for (auto bits = left[w]; bits != 0; bits &= bits - 1) {
+            auto const A = w * 64 + std::countr_zero(bits);
+            for (auto const &[B, offset] : rules.binary_rules[A]) {
+              if (((right[B / 64] >> (B % 64)) & 1) == 0) {
+                continue;
+              }
+              instrumentation::add(instrumentation::counter::CNF_cell_merge);
+              auto const *heads = rules.head_bitsets.data() + offset;
+              for (size_t k = 0; k < word_number; k++) {
+                result[k] |= heads[k];
+              }
             }
           }
         }
       }
     }
-    return table[0][view.size() - 1].contains(get_start_symbol());
   }
-  void CNF::make_reverse_productions() const {
-    if (!reverse_productions.empty()) {
-      return;
-    }
-    for (auto const &[head, bodies] : get_productions()) {
-      for (auto const &body : bodies) {
-        reverse_productions[body].emplace(head);
+
+  CNF::CYK_rules_type CNF::make_CYK_rules() const {
+    auto const &grammar = get_interned_grammar();
+    CYK_rules_type rules;
+    auto const nonterminal_number = grammar.get_nonterminal_number();
+    rules.word_number = (nonterminal_number + 63) / 64;
+    rules.binary_rules.resize(nonterminal_number);
+    auto set_bit = [](uint64_t *bitset, nonterminal_id_type id) {
+      bitset[id / 64] |= uint64_t(1) << (id % 64);
+    };
+    for (auto const &production : grammar.get_productions()) {
+      auto const &body = production.body;
+      if (body.empty()) {
+        rules.start_symbol_nullable = true;
+        continue;
+      }
+      if (body.size() == 1) {
+        auto &heads = rules.terminal_heads[body[0].get_terminal()];
+        heads.resize(rules.word_number, 0);
+        set_bit(heads.data(), production.head);
+        continue;
+      }
+      auto const A = body[0].get_nonterminal();
+      auto const B = body[1].get_nonterminal();
+      auto &right_rules = rules.binary_rules[A];
+      auto it = std::ranges::find(right_rules, B,
+                                  &std::pair<nonterminal_id_type, size_t>::first);
+      if (it == right_rules.end()) {
+        right_rules.emplace_back(B, rules.head_bitsets.size());
+        rules.head_bitsets.resize(rules.head_bitsets.size() + rules.word_number,
+                                  0);
+        it = right_rules.end() - 1;
       }
+      set_bit(rules.head_bitsets.data() + it->second, production.head);
     }
+    return rules;
   }
 
 } // namespace cyy::computation
@@ -5,11 +5,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 #include "cfg.hpp"
 #include "exception.hpp"
+#include "once_cache.hpp"
 
 namespace cyy::computation {
 
@@ -43,13 +45,50 @@ namespace cyy::computation {
     ~CNF() override = default;
 
     [[nodiscard]] bool parse(symbol_string_view view) const;
+    //! CYK where the cells of each span length are computed by thread_number
+    //! threads taking grain_size cells at a time, thread_number 0 means the
+    //! hardware concurrency
+    [[nodiscard]] bool parallel_parse(symbol_string_view view,
+                                      size_t thread_number = 0,
+                                      size_t grain_size = 16) const;
 
   private:
+    //! Productions indexed by body for CYK, sets of nonterminals are
+    //! bitsets of word_number words over interned IDs
+    struct CYK_rules_type {
+      size_t word_number{1};
+      bool start_symbol_nullable{false};
+      std::unordered_map<terminal_type, std::vector<uint64_t>> terminal_heads;
+      //! for each left body nonterminal, the right body nonterminals with
+      //! the offsets of their head bitsets
+      std::vector<std::vector<std::pair<nonterminal_id_type, size_t>>>
+          binary_rules;
+      std::vector<uint64_t> head_bitsets;
+    };
+    //! Cells stored diagonal by diagonal, i.e. by span length
+    class CYK_table {
+    public:
+      CYK_table(size_t input_length, size_t word_number);
+      uint64_t *get_cell(size_t span_length, size_t begin) noexcept {
+        return cells.data() +
+               (diagonal_offsets[span_length] + begin) * word_number;
+      }
+
+    private:
+      size_t word_number;
+      std::vector<size_t> diagonal_offsets;
+      std::vector<uint64_t> cells;
+    };
     bool valid() const;
-    void make_reverse_productions() const;
+    CYK_rules_type make_CYK_rules() const;
+    //! Fills the cells of span length 1, fails on a terminal without
+    //! productions
+    static bool fill_terminal_cells(const CYK_rules_type &rules,
+                                    symbol_string_view view, CYK_table &table);
+    //! Fills the cells of span_length starting from [begin, end)
+    static void fill_cells(const CYK_rules_type &rules, CYK_table &table,
+                           size_t span_length, size_t begin, size_t end);
 
-    mutable std::unordered_map<CFG_production::body_type,
-                               std::unordered_set<nonterminal_type>>
-        reverse_productions;
+    once_cache<CYK_rules_type> CYK_rules;
   };
 } // namespace cyy::computation
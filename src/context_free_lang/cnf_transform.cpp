@@ -64,22 +64,13 @@ namespace cyy::computation {
   }
 
   CFG::nonterminal_set_type CFG::nullable() const {
+    auto const &grammar = get_interned_grammar();
+    auto const &grammar_sets = get_grammar_analysis();
     nonterminal_set_type nullable_nonterminals;
-
-    bool has_new_nullable_nonterminals = true;
-    while (has_new_nullable_nonterminals) {
-      has_new_nullable_nonterminals = false;
-      for (const auto &[head, bodies] : productions) {
-        for (auto const &body : bodies) {
-          if (std::ranges::all_of(body, [&](auto const &symbol) {
-                return symbol.is_nonterminal() &&
-                       nullable_nonterminals.contains(
-                           *symbol.get_nonterminal_ptr());
-              })) {
-            has_new_nullable_nonterminals =
-                nullable_nonterminals.emplace(head).second;
-          }
-        }
+    for (nonterminal_id_type id = 0; id < grammar.get_nonterminal_number();
+         id++) {
+      if (grammar_sets.is_nullable(id)) {
+        nullable_nonterminals.insert(grammar.get_name(id));
       }
     }
     return nullable_nonterminals;
@@ -124,6 +115,7 @@ namespace cyy::computation {
     auto new_start_symbol = get_new_head(start_symbol);
     productions[new_start_symbol] = {{std::move(start_symbol)}};
     start_symbol = std::move(new_start_symbol);
+    clear_caches();
     eliminate_single_productions();
 
     std::unordered_map<terminal_type, nonterminal_type> terminal_to_nonterminal;
@@ -3,82 +3,125 @@
  *
  */
 
-#include <cyy/algorithm/hash.hpp>
 #include "dk.hpp"
-#include "regular_lang/nfa.hpp"
 
-namespace cyy::computation {
-  DK_DFA::DK_DFA(const CFG &cfg) : DK_DFA_base(cfg) {
-    using state_set_type = NFA::state_set_type;
+#include <algorithm>
+#include <optional>
 
-    std::unordered_map<LR_0_item, state_type> item_to_nfa_state_map;
+#include <boost/container_hash/hash.hpp>
+#include <cyy/algorithm/alphabet/union_alphabet.hpp>
 
-    NFA nfa{{0}, cfg.get_full_alphabet(), 0, {}, {}};
-    auto item_to_nfa_state = [&item_to_nfa_state_map,
-                              &nfa](const LR_0_item &item) {
-      auto it = item_to_nfa_state_map.find(item);
-      if (it == item_to_nfa_state_map.end()) {
-        const auto new_state = nfa.add_new_state();
-        item_to_nfa_state_map.emplace(item, new_state);
-        return new_state;
+namespace cyy::computation {
+  DK_DFA::DK_DFA(const CFG &cfg) : DK_DFA_base(cfg) {
+    using symbol_type = cyy::algorithm::symbol_type;
+    // an item is the offset of its production plus its dot
+    using kernel_type = std::vector<uint32_t>;
+    struct kernel_hash {
+      size_t operator()(const kernel_type &kernel) const noexcept {
+        return boost::hash_range(kernel.begin(), kernel.end());
       }
-      return it->second;
     };
 
-    std::unordered_map<CFG::nonterminal_type, state_set_type> head_states;
-    for (auto const &[head, bodies] : cfg.get_productions()) {
-      for (auto const &body : bodies) {
-        cyy::computation::LR_0_item const init_item(head, body);
-        auto state = item_to_nfa_state(init_item);
-        if (head == cfg.get_start_symbol()) {
-          nfa.add_epsilon_transition(nfa.get_start_state(), {state});
-        }
-        head_states[head].emplace(state);
-      }
+    auto const grammar_ptr = cfg.get_shared_interned_grammar();
+    auto const &grammar = *grammar_ptr;
+    std::vector<uint32_t> item_offsets;
+    std::vector<uint32_t> item_productions;
+    for (size_t index = 0; index < grammar.get_production_number(); index++) {
+      item_offsets.push_back(static_cast<uint32_t>(item_productions.size()));
+      item_productions.insert(item_productions.end(),
+                              grammar.get_production(index).body.size() + 1,
+                              static_cast<uint32_t>(index));
     }
+    std::vector<symbol_type> nonterminal_symbols;
+    for (nonterminal_id_type id = 0; id < grammar.get_nonterminal_number();
+         id++) {
+      nonterminal_symbols.push_back(
+          alphabet_of_nonterminals->get_symbol(grammar.get_name(id)));
+    }
+    auto const full_alphabet = std::make_shared<cyy::algorithm::union_alphabet>(
+        cfg.get_terminal_alphabet(), alphabet_of_nonterminals);
 
-    for (auto const &[head, bodies] : cfg.get_productions()) {
-      for (auto const &body : bodies) {
-        cyy::computation::LR_0_item cur_item(head, body);
-
-        for (auto const &grammar_symbol : body) {
-          auto next_item = cur_item;
-          next_item.go();
-          NFA::input_symbol_type symbol{};
-          const auto cur_state = item_to_nfa_state(cur_item);
-          if (grammar_symbol.is_terminal()) {
-            symbol = grammar_symbol.get_terminal();
-          } else {
-            nfa.add_epsilon_transition(
-                cur_state,
-                state_set_type(head_states[grammar_symbol.get_nonterminal()]));
-            symbol = alphabet_of_nonterminals->get_symbol(
-                grammar_symbol.get_nonterminal());
-          }
-          nfa.add_transition({.state = cur_state, .input_symbol = symbol},
-                             {item_to_nfa_state(next_item)});
-          cur_item = next_item;
+    std::vector<size_t> predicted(grammar.get_nonterminal_number(), 0);
+    size_t closure_number = 0;
+    // the kernel followed by the initial items of the predicted nonterminals
+    auto closure = [&](kernel_type items,
+                       std::optional<nonterminal_id_type> predicted_head) {
+      closure_number++;
+      auto predict = [&](nonterminal_id_type head) {
+        if (predicted[head] == closure_number) {
+          return;
+        }
+        predicted[head] = closure_number;
+        for (auto const index : grammar.get_production_indices(head)) {
+          items.push_back(item_offsets[index]);
         }
-        assert(cur_item.completed());
-        nfa.add_final_state(item_to_nfa_state(cur_item));
+      };
+      if (predicted_head.has_value()) {
+        predict(*predicted_head);
       }
-    }
-    std::unordered_map<state_type, LR_0_item> nfa_state_to_item_map;
-    for (auto &[k, v] : std::move(item_to_nfa_state_map)) {
-      nfa_state_to_item_map.emplace(std::move(v), std::move(k));
-    }
+      for (size_t i = 0; i < items.size(); i++) {
+        auto const index = item_productions[items[i]];
+        auto const dot = items[i] - item_offsets[index];
+        auto const &body = grammar.get_production(index).body;
+        if (dot < body.size() && body[dot].is_nonterminal()) {
+          predict(body[dot].get_nonterminal());
+        }
+      }
+      return items;
+    };
 
-    auto [dfa, dfa_to_nfa_state_map] = nfa.to_DFA_with_mapping();
-    for (auto const &[nfa_state_set, dfa_state] : dfa_to_nfa_state_map) {
-      auto &item_set = collection[dfa_state];
-      for (auto const &nfa_state : nfa_state_set) {
-        auto it = nfa_state_to_item_map.find(nfa_state);
-        if (it != nfa_state_to_item_map.end()) {
-          item_set.add_item(it->second);
+    // States are numbered in the same breadth-first order over the full
+    // alphabet as the subset construction, the empty kernel is the dead
+    // state and the start state has no kernel.
+    std::unordered_map<kernel_type, state_type, kernel_hash> kernel_states;
+    std::vector<kernel_type> state_kernels(1);
+    DFA::transition_function_type transition_function;
+    DFA::state_set_type states;
+    DFA::state_set_type final_states;
+    for (state_type state = 0; state < state_kernels.size(); state++) {
+      states.insert(state);
+      auto const items =
+          state == 0 ? closure({}, interned_grammar::start_symbol)
+                     : closure(state_kernels[state], std::nullopt);
+      auto &item_set = collection[state];
+      std::unordered_map<symbol_type, kernel_type> goto_kernels;
+      for (auto const item : items) {
+        auto const index = item_productions[item];
+        auto const dot = item - item_offsets[index];
+        auto const &production = grammar.get_production(index);
+        if (dot == production.body.size()) {
+          final_states.insert(state);
+          item_set.add_item(LR_0_item(grammar_ptr, index, dot));
+          continue;
+        }
+        if (dot == 0) {
+          item_set.add_nonkernel_item(grammar.get_name(production.head));
+        } else {
+          item_set.add_item(LR_0_item(grammar_ptr, index, dot));
+        }
+        auto const &symbol = production.body[dot];
+        goto_kernels[symbol.is_terminal()
+                         ? symbol.get_terminal()
+                         : nonterminal_symbols[symbol.get_nonterminal()]]
+            .push_back(item + 1);
+      }
+      for (auto const symbol : full_alphabet->get_view()) {
+        kernel_type kernel;
+        if (auto it = goto_kernels.find(symbol); it != goto_kernels.end()) {
+          kernel = std::move(it->second);
+          std::ranges::sort(kernel);
+        }
+        auto [it, has_emplaced] =
+            kernel_states.try_emplace(std::move(kernel), state_kernels.size());
+        if (has_emplaced) {
+          state_kernels.push_back(it->first);
         }
+        transition_function[{state, symbol}] = it->second;
       }
     }
-    dfa_ptr = std::make_shared<DFA>(std::move(dfa));
+    dfa_ptr = std::make_shared<DFA>(std::move(states), full_alphabet, 0,
+                                    std::move(transition_function),
+                                    std::move(final_states));
   }
 
   const LR_0_item_set &DK_DFA::get_LR_0_item_set(state_type state) const {
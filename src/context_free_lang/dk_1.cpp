@@ -27,9 +27,11 @@ namespace cyy::computation {
     CFG::terminal_set_type const init_follows = {ALPHABET::endmarker};
 
     // begin from start symbol
-    auto const &start_symbol = cfg.get_start_symbol();
-    for (auto const &body : cfg.get_productions().at(start_symbol)) {
-      LR_1_item const init_item(LR_0_item{start_symbol, body}, init_follows);
+    auto const grammar_ptr = cfg.get_shared_interned_grammar();
+    auto const &grammar = *grammar_ptr;
+    for (auto const index :
+         grammar.get_production_indices(interned_grammar::start_symbol)) {
+      LR_1_item const init_item(LR_0_item{grammar_ptr, index}, init_follows);
       auto state = item_to_nfa_state(init_item);
       nfa.add_epsilon_transition(nfa.get_start_state(), {state});
     }
@@ -53,8 +55,10 @@ namespace cyy::computation {
         auto const &head = grammar_symbol.get_nonterminal();
         symbol = alphabet_of_nonterminals->get_symbol(head);
         auto follow_set = cur_item.follow_of_dot(cfg);
-        for (auto const &body : cfg.get_bodies(head)) {
-          LR_1_item const item(LR_0_item{head, body}, follow_set);
+        auto const id = grammar.get_id(head);
+        assert(id.has_value());
+        for (auto const index : grammar.get_production_indices(*id)) {
+          LR_1_item const item(LR_0_item{grammar_ptr, index}, follow_set);
           nfa.add_epsilon_transition(cur_state, {item_to_nfa_state(item)});
         }
       }
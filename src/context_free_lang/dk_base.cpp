@@ -5,6 +5,8 @@
 
 #include "dk_base.hpp"
 
+#include <optional>
+
 namespace cyy::computation {
   DK_DFA_base::DK_DFA_base(const CFG &cfg)
       : alphabet_of_nonterminals(cfg.get_nonterminal_alphabet()) {}
@@ -12,15 +14,16 @@ namespace cyy::computation {
   DK_DFA_base::goto_table_type
   DK_DFA_base::get_goto_table(bool skip_fail_state) const {
     goto_table_type goto_table;
+    std::optional<DFA::state_bitset_type> useful_states;
+    if (skip_fail_state) {
+      useful_states = dfa_ptr->get_useful_state_bitset();
+    }
     for (auto const &[situation, next_state] :
          dfa_ptr->get_transition_function()) {
-      if (skip_fail_state) {
-        if (!dfa_ptr->is_live_state(situation.state)) {
-          continue;
-        }
-        if (!dfa_ptr->is_live_state(next_state)) {
-          continue;
-        }
+      if (useful_states.has_value() &&
+          (!useful_states->test(dfa_ptr->get_state_index(situation.state)) ||
+           !useful_states->test(dfa_ptr->get_state_index(next_state)))) {
+        continue;
       }
       if (alphabet_of_nonterminals->contain(situation.input_symbol)) {
         goto_table[{situation.state, alphabet_of_nonterminals->get_data(
@@ -0,0 +1,263 @@
+/*!
+ * \file earley_parser.cpp
+ *
+ * \brief Earley parsing of arbitrary context-free grammars
+ */
+
+#include "earley_parser.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "instrumentation.hpp"
+
+namespace cyy::computation {
+
+  class Earley_parser::chart {
+  public:
+    struct set_type {
+      std::vector<item_type> items;
+      std::unordered_set<uint64_t> item_keys;
+      //! indices of the items with the nonterminal after the dot
+      std::unordered_map<nonterminal_id_type, std::vector<uint32_t>> waiting;
+      std::unordered_map<nonterminal_id_type, std::optional<item_type>>
+          Leo_items;
+    };
+
+    chart(const std::vector<uint32_t> &item_offsets_, size_t input_length)
+        : item_offsets(item_offsets_), sets(input_length + 1) {}
+
+    set_type &operator[](size_t set_index) { return sets[set_index]; }
+    const set_type &operator[](size_t set_index) const {
+      return sets[set_index];
+    }
+
+    bool add(size_t set_index, item_type item) {
+      auto &set = sets[set_index];
+      if (!set.item_keys.insert(get_key(item)).second) {
+        return false;
+      }
+      instrumentation::add(instrumentation::counter::Earley_item);
+      set.items.push_back(item);
+      return true;
+    }
+    bool contains(size_t set_index, item_type item) const {
+      return sets[set_index].item_keys.contains(get_key(item));
+    }
+
+  private:
+    uint64_t get_key(item_type item) const noexcept {
+      return (static_cast<uint64_t>(item_offsets[item.production] + item.dot)
+              << 32) |
+             item.origin;
+    }
+
+    const std::vector<uint32_t> &item_offsets;
+    std::vector<set_type> sets;
+  };
+
+  Earley_parser::Earley_parser(const CFG &cfg)
+      : grammar(cfg.get_interned_grammar()) {
+    auto const &analysis = cfg.get_grammar_analysis();
+    nullable.resize(grammar.get_nonterminal_number());
+    for (nonterminal_id_type id = 0; id < grammar.get_nonterminal_number();
+         id++) {
+      nullable[id] = analysis.is_nullable(id);
+    }
+    uint32_t item_number = 0;
+    for (auto const &production : grammar.get_productions()) {
+      item_offsets.push_back(item_number);
+      item_number += static_cast<uint32_t>(production.body.size() + 1);
+    }
+  }
+
+  bool Earley_parser::recognize(symbol_string_view view) const {
+    instrumentation::add(instrumentation::counter::Earley_parse);
+    return get_accepted_item(make_chart(view, true), view.size()).has_value();
+  }
+
+  CFG::parse_node_ptr
+  Earley_parser::get_parse_tree(symbol_string_view view) const {
+    instrumentation::add(instrumentation::counter::Earley_parse);
+    auto const sets = make_chart(view, false);
+    auto accepted_item = get_accepted_item(sets, view.size());
+    if (!accepted_item) {
+      return {};
+    }
+    std::vector<std::pair<item_type, size_t>> building;
+    return build_node(sets, view, *accepted_item, view.size(), building);
+  }
+
+  Earley_parser::chart Earley_parser::make_chart(symbol_string_view view,
+                                                 bool use_Leo_items) const {
+    auto const n = view.size();
+    chart sets(item_offsets, n);
+    for (auto const index :
+         grammar.get_production_indices(interned_grammar::start_symbol)) {
+      sets.add(0, {static_cast<uint32_t>(index), 0, 0});
+    }
+    for (size_t i = 0; i <= n; i++) {
+      // the set grows while it is processed
+      for (size_t k = 0; k < sets[i].items.size(); k++) {
+        auto const item = sets[i].items[k];
+        auto const &body = grammar.get_production(item.production).body;
+        if (item.dot == body.size()) {
+          // a completion of an empty span is covered by skipping nullable
+          // nonterminals at prediction
+          if (item.origin == i) {
+            continue;
+          }
+          auto const head = grammar.get_production(item.production).head;
+          if (use_Leo_items) {
+            if (auto Leo_item = get_Leo_item(sets, item.origin, head)) {
+              sets.add(i, *Leo_item);
+              continue;
+            }
+          }
+          auto const &origin_set = sets[item.origin];
+          auto it = origin_set.waiting.find(head);
+          if (it == origin_set.waiting.end()) {
+            continue;
+          }
+          for (auto const index : it->second) {
+            auto waiting_item = origin_set.items[index];
+            waiting_item.dot++;
+            sets.add(i, waiting_item);
+          }
+          continue;
+        }
+        auto const &symbol = body[item.dot];
+        auto next_item = item;
+        next_item.dot++;
+        if (symbol.is_terminal()) {
+          if (i < n && view[i] == symbol.get_terminal()) {
+            sets.add(i + 1, next_item);
+          }
+          continue;
+        }
+        auto const nonterminal = symbol.get_nonterminal();
+        auto [it, first_waiting] = sets[i].waiting.try_emplace(nonterminal);
+        it->second.push_back(static_cast<uint32_t>(k));
+        if (first_waiting) {
+          for (auto const index : grammar.get_production_indices(nonterminal)) {
+            sets.add(i, {static_cast<uint32_t>(index), 0,
+                         static_cast<uint32_t>(i)});
+          }
+        }
+        if (nullable[nonterminal]) {
+          sets.add(i, next_item);
+        }
+      }
+    }
+    return sets;
+  }
+
+  std::optional<Earley_parser::item_type>
+  Earley_parser::get_Leo_item(chart &sets, size_t set_index,
+                              nonterminal_id_type nonterminal) const {
+    auto &set = sets[set_index];
+    if (auto it = set.Leo_items.find(nonterminal); it != set.Leo_items.end()) {
+      return it->second;
+    }
+    // The path is deterministic while exactly one item waits for the
+    // nonterminal and the nonterminal ends its body.
+    std::optional<item_type> Leo_item;
+    auto it = set.waiting.find(nonterminal);
+    if (it != set.waiting.end() && it->second.size() == 1) {
+      auto item = set.items[it->second[0]];
+      auto const &production = grammar.get_production(item.production);
+      if (item.dot + 1 == production.body.size()) {
+        // completed start items must stay in the chart for acceptance
+        if (item.origin < set_index &&
+            !(item.origin == 0 &&
+              production.head == interned_grammar::start_symbol)) {
+          Leo_item = get_Leo_item(sets, item.origin, production.head);
+        }
+        if (!Leo_item) {
+          item.dot++;
+          Leo_item = item;
+        }
+      }
+    }
+    set.Leo_items.emplace(nonterminal, Leo_item);
+    return Leo_item;
+  }
+
+  std::optional<Earley_parser::item_type>
+  Earley_parser::get_accepted_item(const chart &sets,
+                                   size_t input_length) const {
+    for (auto const index :
+         grammar.get_production_indices(interned_grammar::start_symbol)) {
+      item_type const item{
+          static_cast<uint32_t>(index),
+          static_cast<uint32_t>(grammar.get_production(index).body.size()), 0};
+      if (sets.contains(input_length, item)) {
+        return item;
+      }
+    }
+    return {};
+  }
+
+  CFG::parse_node_ptr Earley_parser::build_node(
+      const chart &sets, symbol_string_view view, item_type completed_item,
+      size_t end, std::vector<std::pair<item_type, size_t>> &building) const {
+    // ancestors with the same span are on the top of the stack
+    for (auto it = building.rbegin();
+         it != building.rend() && it->first.origin == completed_item.origin &&
+         it->second == end;
+         ++it) {
+      if (it->first == completed_item) {
+        return {};
+      }
+    }
+    building.emplace_back(completed_item, end);
+    auto const &production = grammar.get_production(completed_item.production);
+    auto node = std::make_shared<CFG::parse_node>(
+        grammar.get_name(production.head));
+    node->children.resize(production.body.size());
+
+    // Match the body from right to left, the item before each symbol must
+    // be in the set where the symbol starts.
+    std::function<bool(uint32_t, size_t)> match_prefix =
+        [&](uint32_t dot, size_t pos) -> bool {
+      if (dot == 0) {
+        return pos == completed_item.origin;
+      }
+      item_type const prefix_item{completed_item.production, dot - 1,
+                                  completed_item.origin};
+      auto const &symbol = production.body[dot - 1];
+      if (symbol.is_terminal()) {
+        if (pos == 0 || view[pos - 1] != symbol.get_terminal() ||
+            !sets.contains(pos - 1, prefix_item)) {
+          return false;
+        }
+        node->children[dot - 1] =
+            std::make_shared<CFG::parse_node>(symbol.get_terminal());
+        return match_prefix(dot - 1, pos - 1);
+      }
+      for (auto const &item : sets[pos].items) {
+        auto const &child_production = grammar.get_production(item.production);
+        if (child_production.head != symbol.get_nonterminal() ||
+            item.dot != child_production.body.size() ||
+            item.origin < completed_item.origin ||
+            !sets.contains(item.origin, prefix_item)) {
+          continue;
+        }
+        auto child = build_node(sets, view, item, pos, building);
+        if (child && match_prefix(dot - 1, item.origin)) {
+          node->children[dot - 1] = std::move(child);
+          return true;
+        }
+      }
+      return false;
+    };
+    auto const matched = match_prefix(
+        static_cast<uint32_t>(production.body.size()), end);
+    building.pop_back();
+    if (!matched) {
+      return {};
+    }
+    return node;
+  }
+} // namespace cyy::computation
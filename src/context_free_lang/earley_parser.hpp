@@ -0,0 +1,63 @@
+/*!
+ * \file earley_parser.hpp
+ *
+ * \brief Earley parsing of arbitrary context-free grammars
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "cfg.hpp"
+#include "interned_grammar.hpp"
+
+namespace cyy::computation {
+
+  //! Earley parser working directly on the productions of a CFG. Nullable
+  //! nonterminals are skipped at prediction (Aycock and Horspool) and
+  //! deterministic right recursion is completed in one step (Leo), so the
+  //! parser is cubic in the worst case and linear on LR-regular grammars.
+  class Earley_parser {
+  public:
+    using symbol_string_view = CFG::symbol_string_view;
+
+    explicit Earley_parser(const CFG &cfg);
+
+    bool recognize(symbol_string_view view) const;
+    //! One of the parse trees, nullptr if the view is not in the language
+    CFG::parse_node_ptr get_parse_tree(symbol_string_view view) const;
+
+  private:
+    struct item_type {
+      uint32_t production;
+      uint32_t dot;
+      uint32_t origin;
+      bool operator==(const item_type &) const noexcept = default;
+    };
+    class chart;
+
+    //! Leo items skip the intermediate completed items that get_parse_tree
+    //! walks through, so the tree is built from a chart without them
+    chart make_chart(symbol_string_view view, bool use_Leo_items) const;
+    //! The topmost item of the deterministic reduction path above the items
+    //! of set_index waiting for nonterminal
+    std::optional<item_type> get_Leo_item(chart &sets, size_t set_index,
+                                          nonterminal_id_type nonterminal) const;
+    std::optional<item_type> get_accepted_item(const chart &sets,
+                                               size_t input_length) const;
+    //! building holds the items and ends of the ancestors to break cycles of
+    //! unit and nullable productions
+    CFG::parse_node_ptr
+    build_node(const chart &sets, symbol_string_view view,
+               item_type completed_item, size_t end,
+               std::vector<std::pair<item_type, size_t>> &building) const;
+
+    interned_grammar grammar;
+    std::vector<bool> nullable;
+    //! LR(0) item ID of a production and dot is its offset plus the dot
+    std::vector<uint32_t> item_offsets;
+  };
+} // namespace cyy::computation
@@ -0,0 +1,199 @@
+/*!
+ * \file grammar_analysis.cpp
+ *
+ * \brief nullable, FIRST and FOLLOW sets over terminal bitsets
+ */
+
+#include "grammar_analysis.hpp"
+
+#include <algorithm>
+
+#include <cyy/algorithm/alphabet/alphabet.hpp>
+
+namespace cyy::computation {
+  grammar_analysis::grammar_analysis(const interned_grammar &grammar) {
+    auto add_terminal = [this](terminal_type terminal) {
+      auto [it, has_emplaced] =
+          terminal_indices.try_emplace(terminal, terminals.size());
+      if (has_emplaced) {
+        terminals.push_back(terminal);
+      }
+    };
+    add_terminal(cyy::algorithm::ALPHABET::endmarker);
+    for (auto const &production : grammar.get_productions()) {
+      for (auto const &symbol : production.body) {
+        if (symbol.is_terminal()) {
+          add_terminal(symbol.get_terminal());
+        }
+      }
+    }
+    compute_nullable(grammar);
+    compute_first(grammar);
+    compute_body_suffix_first(grammar);
+    compute_follow(grammar);
+  }
+
+  std::optional<size_t>
+  grammar_analysis::get_terminal_index(terminal_type terminal) const {
+    auto it = terminal_indices.find(terminal);
+    if (it == terminal_indices.end()) {
+      return {};
+    }
+    return it->second;
+  }
+
+  std::unordered_set<grammar_analysis::terminal_type>
+  grammar_analysis::to_terminal_set(const terminal_bitset_type &bitset) const {
+    std::unordered_set<terminal_type> terminal_set;
+    for (auto i = bitset.find_first(); i != terminal_bitset_type::npos;
+         i = bitset.find_next(i)) {
+      terminal_set.insert(terminals[i]);
+    }
+    return terminal_set;
+  }
+
+  void grammar_analysis::compute_nullable(const interned_grammar &grammar) {
+    auto const nonterminal_number = grammar.get_nonterminal_number();
+    nullable.assign(nonterminal_number, false);
+    // a production is nullable once all its body nonterminals are
+    std::vector<size_t> remaining(grammar.get_production_number(), 0);
+    std::vector<std::vector<size_t>> occurrences(nonterminal_number);
+    std::vector<nonterminal_id_type> worklist;
+    for (size_t index = 0; index < grammar.get_production_number(); index++) {
+      auto const &production = grammar.get_production(index);
+      if (std::ranges::any_of(production.body, [](auto const &symbol) {
+            return symbol.is_terminal();
+          })) {
+        continue;
+      }
+      remaining[index] = production.body.size();
+      for (auto const &symbol : production.body) {
+        occurrences[symbol.get_nonterminal()].push_back(index);
+      }
+      if (production.body.empty() && !nullable[production.head]) {
+        nullable[production.head] = true;
+        worklist.push_back(production.head);
+      }
+    }
+    while (!worklist.empty()) {
+      auto const nonterminal = worklist.back();
+      worklist.pop_back();
+      for (auto const index : occurrences[nonterminal]) {
+        auto const head = grammar.get_production(index).head;
+        if (--remaining[index] == 0 && !nullable[head]) {
+          nullable[head] = true;
+          worklist.push_back(head);
+        }
+      }
+    }
+  }
+
+  void grammar_analysis::compute_first(const interned_grammar &grammar) {
+    auto const nonterminal_number = grammar.get_nonterminal_number();
+    first_sets.assign(nonterminal_number,
+                      terminal_bitset_type(get_terminal_number()));
+    // FIRST(B) flows into FIRST(A) for A -> alpha B beta with nullable alpha
+    std::vector<std::vector<nonterminal_id_type>> edges(nonterminal_number);
+    for (auto const &production : grammar.get_productions()) {
+      for (auto const &symbol : production.body) {
+        if (symbol.is_terminal()) {
+          first_sets[production.head].set(
+              terminal_indices.at(symbol.get_terminal()));
+          break;
+        }
+        auto const nonterminal = symbol.get_nonterminal();
+        if (nonterminal != production.head) {
+          edges[nonterminal].push_back(production.head);
+        }
+        if (!nullable[nonterminal]) {
+          break;
+        }
+      }
+    }
+    propagate(first_sets, edges);
+  }
+
+  void
+  grammar_analysis::compute_body_suffix_first(const interned_grammar &grammar) {
+    suffix_offsets.reserve(grammar.get_production_number());
+    for (auto const &production : grammar.get_productions()) {
+      auto const offset = body_suffix_first_sets.size();
+      suffix_offsets.push_back(offset);
+      auto const body_size = production.body.size();
+      body_suffix_first_sets.resize(
+          offset + body_size + 1,
+          first_set_type{
+              .terminals = terminal_bitset_type(get_terminal_number()),
+              .nullable = false});
+      body_suffix_first_sets[offset + body_size].nullable = true;
+      for (auto i = body_size; i-- > 0;) {
+        auto &suffix_first = body_suffix_first_sets[offset + i];
+        auto const &symbol = production.body[i];
+        if (symbol.is_terminal()) {
+          suffix_first.terminals.set(
+              terminal_indices.at(symbol.get_terminal()));
+          continue;
+        }
+        auto const nonterminal = symbol.get_nonterminal();
+        suffix_first.terminals = first_sets[nonterminal];
+        if (nullable[nonterminal]) {
+          auto const &next_suffix_first =
+              body_suffix_first_sets[offset + i + 1];
+          suffix_first.terminals |= next_suffix_first.terminals;
+          suffix_first.nullable = next_suffix_first.nullable;
+        }
+      }
+    }
+  }
+
+  void grammar_analysis::compute_follow(const interned_grammar &grammar) {
+    auto const nonterminal_number = grammar.get_nonterminal_number();
+    follow_sets.assign(nonterminal_number,
+                       terminal_bitset_type(get_terminal_number()));
+    follow_sets[interned_grammar::start_symbol].set(
+        terminal_indices.at(cyy::algorithm::ALPHABET::endmarker));
+    // FOLLOW(A) flows into FOLLOW(B) for A -> alpha B beta with nullable beta
+    std::vector<std::vector<nonterminal_id_type>> edges(nonterminal_number);
+    for (size_t index = 0; index < grammar.get_production_number(); index++) {
+      auto const &production = grammar.get_production(index);
+      for (size_t i = 0; i < production.body.size(); i++) {
+        auto const &symbol = production.body[i];
+        if (symbol.is_terminal()) {
+          continue;
+        }
+        auto const nonterminal = symbol.get_nonterminal();
+        auto const &rest_first = get_body_suffix_first(index, i + 1);
+        follow_sets[nonterminal] |= rest_first.terminals;
+        if (rest_first.nullable && nonterminal != production.head) {
+          edges[production.head].push_back(nonterminal);
+        }
+      }
+    }
+    propagate(follow_sets, edges);
+  }
+
+  void grammar_analysis::propagate(
+      std::vector<terminal_bitset_type> &sets,
+      const std::vector<std::vector<nonterminal_id_type>> &edges) {
+    std::vector<nonterminal_id_type> worklist;
+    std::vector<bool> in_worklist(sets.size(), true);
+    for (nonterminal_id_type i = 0; i < sets.size(); i++) {
+      worklist.push_back(i);
+    }
+    while (!worklist.empty()) {
+      auto const from = worklist.back();
+      worklist.pop_back();
+      in_worklist[from] = false;
+      for (auto const to : edges[from]) {
+        if (sets[from].is_subset_of(sets[to])) {
+          continue;
+        }
+        sets[to] |= sets[from];
+        if (!in_worklist[to]) {
+          in_worklist[to] = true;
+          worklist.push_back(to);
+        }
+      }
+    }
+  }
+} // namespace cyy::computation
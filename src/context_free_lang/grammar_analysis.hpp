@@ -0,0 +1,75 @@
+/*!
+ * \file grammar_analysis.hpp
+ *
+ * \brief nullable, FIRST and FOLLOW sets over terminal bitsets
+ */
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "interned_grammar.hpp"
+
+namespace cyy::computation {
+  //! Computes nullable, FIRST and FOLLOW of all nonterminals and FIRST of all
+  //! production body suffixes. Each set is propagated along a dependency
+  //! graph with a worklist, so a nonterminal is revisited only when one of
+  //! its sources changes.
+  class grammar_analysis {
+  public:
+    using terminal_type = interned_symbol_type::terminal_type;
+    //! indexed by get_terminal_index
+    using terminal_bitset_type = boost::dynamic_bitset<>;
+    struct first_set_type {
+      terminal_bitset_type terminals;
+      bool nullable{false};
+    };
+
+    explicit grammar_analysis(const interned_grammar &grammar);
+
+    size_t get_terminal_number() const noexcept { return terminals.size(); }
+    terminal_type get_terminal(size_t index) const { return terminals[index]; }
+    std::optional<size_t> get_terminal_index(terminal_type terminal) const;
+    std::unordered_set<terminal_type>
+    to_terminal_set(const terminal_bitset_type &bitset) const;
+
+    bool is_nullable(nonterminal_id_type nonterminal) const {
+      return nullable[nonterminal];
+    }
+    const terminal_bitset_type &get_first(nonterminal_id_type nonterminal) const {
+      return first_sets[nonterminal];
+    }
+    const terminal_bitset_type &
+    get_follow(nonterminal_id_type nonterminal) const {
+      return follow_sets[nonterminal];
+    }
+    //! FIRST of the body of a production from pos
+    const first_set_type &get_body_suffix_first(size_t production_index,
+                                                size_t pos) const {
+      return body_suffix_first_sets[suffix_offsets[production_index] + pos];
+    }
+
+  private:
+    void compute_nullable(const interned_grammar &grammar);
+    void compute_first(const interned_grammar &grammar);
+    void compute_body_suffix_first(const interned_grammar &grammar);
+    void compute_follow(const interned_grammar &grammar);
+    //! Propagate sets[from] into sets[to] for every edge until no set changes
+    static void
+    propagate(std::vector<terminal_bitset_type> &sets,
+              const std::vector<std::vector<nonterminal_id_type>> &edges);
+
+    std::vector<terminal_type> terminals;
+    std::unordered_map<terminal_type, size_t> terminal_indices;
+    std::vector<bool> nullable;
+    std::vector<terminal_bitset_type> first_sets;
+    std::vector<terminal_bitset_type> follow_sets;
+    std::vector<size_t> suffix_offsets;
+    std::vector<first_set_type> body_suffix_first_sets;
+  };
+} // namespace cyy::computation
@@ -0,0 +1,61 @@
+/*!
+ * \file interned_grammar.cpp
+ *
+ * \brief productions with nonterminals interned as dense integer IDs
+ */
+
+#include "interned_grammar.hpp"
+
+namespace cyy::computation {
+  interned_grammar::interned_grammar(const nonterminal_type &start_symbol_,
+                                     const production_set_type &productions_) {
+    intern(start_symbol_);
+    for (auto const &[head, _] : productions_) {
+      intern(head);
+    }
+    // heads have the smallest IDs, so grouping follows ID order
+    auto const head_number = names.size();
+    for (nonterminal_id_type head_id = 0; head_id < head_number; head_id++) {
+      head_offsets.push_back(productions.size());
+      auto it = productions_.find(names[head_id]);
+      if (it == productions_.end()) {
+        continue;
+      }
+      for (auto const &body : it->second) {
+        interned_production production{.head = head_id, .body = {}};
+        production.body.reserve(body.size());
+        for (auto const &symbol : body) {
+          if (symbol.is_terminal()) {
+            production.body.push_back(
+                interned_symbol_type::terminal(symbol.get_terminal()));
+          } else {
+            production.body.push_back(interned_symbol_type::nonterminal(
+                intern(symbol.get_nonterminal())));
+          }
+        }
+        productions.push_back(std::move(production));
+        original_productions.emplace_back(it->first, body);
+      }
+    }
+    // nonterminals without productions
+    head_offsets.resize(names.size() + 1, productions.size());
+  }
+
+  std::optional<nonterminal_id_type>
+  interned_grammar::get_id(const nonterminal_type &name) const {
+    auto it = ids.find(name);
+    if (it == ids.end()) {
+      return {};
+    }
+    return it->second;
+  }
+
+  nonterminal_id_type interned_grammar::intern(const nonterminal_type &name) {
+    auto [it, has_emplaced] =
+        ids.try_emplace(name, static_cast<nonterminal_id_type>(names.size()));
+    if (has_emplaced) {
+      names.push_back(name);
+    }
+    return it->second;
+  }
+} // namespace cyy::computation
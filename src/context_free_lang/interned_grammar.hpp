@@ -0,0 +1,104 @@
+/*!
+ * \file interned_grammar.hpp
+ *
+ * \brief productions with nonterminals interned as dense integer IDs
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cfg_production.hpp"
+
+namespace cyy::computation {
+  using nonterminal_id_type = uint32_t;
+
+  //! A grammar symbol whose nonterminal is replaced by its ID
+  class interned_symbol_type {
+  public:
+    using terminal_type = grammar_symbol_type::terminal_type;
+    static constexpr interned_symbol_type
+    terminal(terminal_type terminal) noexcept {
+      return {static_cast<uint64_t>(terminal), true};
+    }
+    static constexpr interned_symbol_type
+    nonterminal(nonterminal_id_type id) noexcept {
+      return {id, false};
+    }
+    constexpr bool is_terminal() const noexcept { return is_terminal_; }
+    constexpr bool is_nonterminal() const noexcept { return !is_terminal_; }
+    constexpr terminal_type get_terminal() const noexcept {
+      return static_cast<terminal_type>(value);
+    }
+    constexpr nonterminal_id_type get_nonterminal() const noexcept {
+      return static_cast<nonterminal_id_type>(value);
+    }
+    bool operator==(const interned_symbol_type &) const noexcept = default;
+
+  private:
+    constexpr interned_symbol_type(uint64_t value_, bool terminal_) noexcept
+        : value(value_), is_terminal_(terminal_) {}
+    uint64_t value;
+    bool is_terminal_;
+  };
+
+  struct interned_production {
+    nonterminal_id_type head;
+    std::vector<interned_symbol_type> body;
+  };
+
+  //! Compiled form of a grammar for parsers and analyses. The start symbol
+  //! gets ID 0, the productions are grouped by head. Names are only needed
+  //! for I/O.
+  class interned_grammar {
+  public:
+    using nonterminal_type = CFG_production::head_type;
+    using production_set_type =
+        std::unordered_map<nonterminal_type,
+                           std::unordered_set<CFG_production::body_type>>;
+
+    interned_grammar(const nonterminal_type &start_symbol_,
+                     const production_set_type &productions);
+
+    static constexpr nonterminal_id_type start_symbol = 0;
+    size_t get_nonterminal_number() const noexcept { return names.size(); }
+    const nonterminal_type &get_name(nonterminal_id_type id) const {
+      return names[id];
+    }
+    std::optional<nonterminal_id_type>
+    get_id(const nonterminal_type &name) const;
+
+    size_t get_production_number() const noexcept {
+      return productions.size();
+    }
+    const std::vector<interned_production> &get_productions() const noexcept {
+      return productions;
+    }
+    const interned_production &get_production(size_t index) const {
+      return productions[index];
+    }
+    //! The original production, for callbacks and messages
+    const CFG_production &get_original_production(size_t index) const {
+      return original_productions[index];
+    }
+    //! Indices of the productions of head
+    auto get_production_indices(nonterminal_id_type head) const noexcept {
+      return std::views::iota(head_offsets[head], head_offsets[head + 1]);
+    }
+
+  private:
+    nonterminal_id_type intern(const nonterminal_type &name);
+
+    std::vector<nonterminal_type> names;
+    std::unordered_map<nonterminal_type, nonterminal_id_type> ids;
+    std::vector<interned_production> productions;
+    std::vector<CFG_production> original_productions;
+    std::vector<size_t> head_offsets;
+  };
+} // namespace cyy::computation
@@ -7,41 +7,201 @@
 
 #include "lalr_grammar.hpp"
 
-#include "exception.hpp"
+#include <cassert>
+#include <functional>
+#include <limits>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "dk.hpp"
 
 namespace cyy::computation {
+  namespace {
+    using terminal_bitset_type = grammar_analysis::terminal_bitset_type;
+
+    //! DeRemer and Pennello's digraph algorithm: the least sets with
+    //! sets[x] containing sets[y] for every y in relation[x], the members of
+    //! a strongly connected component end with the same set
+    void digraph(std::vector<terminal_bitset_type> &sets,
+                 const std::vector<std::vector<size_t>> &relation) {
+      constexpr auto done = std::numeric_limits<size_t>::max();
+      std::vector<size_t> depths(sets.size(), 0);
+      std::vector<size_t> stack;
+      std::function<void(size_t)> traverse = [&](size_t x) {
+        stack.push_back(x);
+        auto const depth = stack.size();
+        depths[x] = depth;
+        for (auto const y : relation[x]) {
+          if (depths[y] == 0) {
+            traverse(y);
+          }
+          depths[x] = std::min(depths[x], depths[y]);
+          sets[x] |= sets[y];
+        }
+        if (depths[x] != depth) {
+          return;
+        }
+        while (true) {
+          auto const top = stack.back();
+          stack.pop_back();
+          depths[top] = done;
+          if (top == x) {
+            break;
+          }
+          sets[top] = sets[x];
+        }
+      };
+      for (size_t x = 0; x < sets.size(); x++) {
+        if (depths[x] == 0) {
+          traverse(x);
+        }
+      }
+    }
+  } // namespace
+
   std::pair<LALR_grammar::collection_type, LALR_grammar::goto_table_type>
-  LALR_grammar::get_collection() const {
-    auto [collection, old_goto_table] = canonical_LR_grammar::get_collection();
-
-    std::unordered_map<LR_0_item_set, DFA::state_set_type> state_sets;
-    for (auto const &[state, lr_1_item_set] : collection) {
-      state_sets[lr_1_item_set.get_lr_0_item_set()].emplace(state);
-    }
-    std::unordered_map<DFA::state_type, DFA::state_type> state_map;
-    collection_type new_collection;
-    for (auto const &[_, state_set] : state_sets) {
-      assert(!state_set.empty());
-      auto it = state_set.begin();
-      auto min_state = *it;
-      auto &item_set = collection[min_state];
-      ++it;
-      state_map[min_state] = min_state;
-      for (; it != state_set.end(); ++it) {
-        item_set.merge_lookahead_symbols(collection[*it]);
-        state_map[*it] = min_state;
+  LALR_grammar::get_collection(const CFG &cfg) const {
+    DK_DFA const dk(cfg);
+    auto goto_table = dk.get_goto_table(true);
+    auto const grammar_ptr = cfg.get_shared_interned_grammar();
+    auto const &grammar = *grammar_ptr;
+    auto const &analysis = cfg.get_grammar_analysis();
+    auto const state_number = dk.get_LR_0_item_set_collection().size();
+
+    // The nonterminal transitions of the LR(0) automaton, the last one is a
+    // virtual transition on the start symbol from the start state whose
+    // follow set is the endmarker.
+    struct transition_type {
+      state_type from;
+      nonterminal_id_type nonterminal;
+      state_type to;
+    };
+    std::vector<transition_type> transitions;
+    std::unordered_map<std::pair<state_type, nonterminal_id_type>, size_t,
+                       boost::hash<std::pair<state_type, nonterminal_id_type>>>
+        transition_indices;
+    std::unordered_map<std::pair<state_type, terminal_type>, state_type,
+                       boost::hash<std::pair<state_type, terminal_type>>>
+        terminal_gotos;
+    std::vector<std::vector<terminal_type>> shifted_terminals(state_number);
+    std::vector<std::vector<size_t>> state_transitions(state_number);
+    for (auto const &[p, next_state] : goto_table) {
+      if (p.second.is_terminal()) {
+        terminal_gotos.emplace(std::pair{p.first, p.second.get_terminal()},
+                               next_state);
+        shifted_terminals[p.first].push_back(p.second.get_terminal());
+        continue;
       }
-      new_collection.try_emplace(min_state, std::move(item_set));
+      auto const id = grammar.get_id(p.second.get_nonterminal());
+      assert(id.has_value());
+      transition_indices.emplace(std::pair{p.first, *id}, transitions.size());
+      state_transitions[p.first].push_back(transitions.size());
+      transitions.emplace_back(p.first, *id, next_state);
     }
+    auto const start_transition = transitions.size();
+    transitions.emplace_back(0, interned_grammar::start_symbol, 0);
 
-    goto_table_type new_goto_table;
+    auto next_state = [&](state_type state,
+                          const interned_symbol_type &symbol) {
+      if (symbol.is_terminal()) {
+        return terminal_gotos.at({state, symbol.get_terminal()});
+      }
+      return transitions[transition_indices.at(
+                             {state, symbol.get_nonterminal()})]
+          .to;
+    };
 
-    for (const auto &[from_config, to_state] : old_goto_table) {
-      new_goto_table.try_emplace(
-          {state_map[from_config.first], from_config.second},
-          state_map[to_state]);
+    // Direct reads and the reads relation
+    std::vector<terminal_bitset_type> follow_sets(
+        transitions.size(),
+        terminal_bitset_type(analysis.get_terminal_number()));
+    std::vector<std::vector<size_t>> relation(transitions.size());
+    for (size_t index = 0; index < start_transition; index++) {
+      auto const to = transitions[index].to;
+      for (auto const terminal : shifted_terminals[to]) {
+        follow_sets[index].set(*analysis.get_terminal_index(terminal));
+      }
+      for (auto const successor : state_transitions[to]) {
+        if (analysis.is_nullable(transitions[successor].nonterminal)) {
+          relation[index].push_back(successor);
+        }
+      }
+    }
+    follow_sets[start_transition].set(
+        *analysis.get_terminal_index(ALPHABET::endmarker));
+    digraph(follow_sets, relation);
+
+    // Walk the productions of each transition through the automaton, the
+    // items passed get the follow set of the transition as lookaheads and a
+    // nonterminal followed by a nullable suffix includes the transition.
+    std::vector<uint32_t> item_offsets;
+    std::vector<uint32_t> item_productions;
+    for (size_t index = 0; index < grammar.get_production_number(); index++) {
+      item_offsets.push_back(static_cast<uint32_t>(item_productions.size()));
+      item_productions.insert(item_productions.end(),
+                              grammar.get_production(index).body.size() + 1,
+                              static_cast<uint32_t>(index));
+    }
+    std::unordered_map<uint64_t, size_t> item_indices;
+    std::vector<uint64_t> items;
+    std::vector<std::vector<size_t>> passed_items(transitions.size());
+    for (auto &successors : relation) {
+      successors.clear();
+    }
+    for (size_t index = 0; index < transitions.size(); index++) {
+      auto const [from, nonterminal, _] = transitions[index];
+      for (auto const production_index :
+           grammar.get_production_indices(nonterminal)) {
+        auto const &body = grammar.get_production(production_index).body;
+        auto state = from;
+        for (size_t dot = 0;; dot++) {
+          auto const item = (static_cast<uint64_t>(state) << 32) |
+                            (item_offsets[production_index] + dot);
+          auto [it, has_emplaced] =
+              item_indices.try_emplace(item, items.size());
+          if (has_emplaced) {
+            items.push_back(item);
+          }
+          passed_items[index].push_back(it->second);
+          if (dot == body.size()) {
+            break;
+          }
+          auto const &symbol = body[dot];
+          if (symbol.is_nonterminal() &&
+              analysis.get_body_suffix_first(production_index, dot + 1)
+                  .nullable) {
+            relation[transition_indices.at(
+                         {state, symbol.get_nonterminal()})]
+                .push_back(index);
+          }
+          state = next_state(state, symbol);
+        }
+      }
+    }
+    digraph(follow_sets, relation);
+
+    std::vector<terminal_bitset_type> lookahead_sets(
+        items.size(), terminal_bitset_type(analysis.get_terminal_number()));
+    for (size_t index = 0; index < transitions.size(); index++) {
+      for (auto const item_index : passed_items[index]) {
+        lookahead_sets[item_index] |= follow_sets[index];
+      }
+    }
+
+    collection_type collection;
+    for (auto const &[state, _] : dk.get_LR_0_item_set_collection()) {
+      collection.try_emplace(state);
+    }
+    for (size_t item_index = 0; item_index < items.size(); item_index++) {
+      auto const state = static_cast<state_type>(items[item_index] >> 32);
+      auto const offset = static_cast<uint32_t>(items[item_index]);
+      auto const production_index = item_productions[offset];
+      collection[state].add_item(LR_1_item(
+          LR_0_item(grammar_ptr, production_index,
+                    offset - item_offsets[production_index]),
+          analysis.to_terminal_set(lookahead_sets[item_index])));
     }
-    return {new_collection, new_goto_table};
+    return {collection, goto_table};
   }
 
 } // namespace cyy::computation
@@ -15,7 +15,11 @@ namespace cyy::computation {
 
   public:
     using canonical_LR_grammar::canonical_LR_grammar;
+    using canonical_LR_grammar::get_collection;
 
-    std::pair<collection_type, goto_table_type> get_collection() const override;
+    //! The LR(0) automaton with lookaheads computed by DeRemer and
+    //! Pennello's reads and includes relations
+    std::pair<collection_type, goto_table_type>
+    get_collection(const CFG &cfg) const override;
   };
 } // namespace cyy::computation
@@ -16,48 +16,41 @@
 
 namespace cyy::computation {
 
-  void LL_grammar::construct_parsing_table() const {
-    auto follow_sets = follow();
-    for (const auto &[head, bodies] : get_productions()) {
-      for (auto const &body : bodies) {
-        auto const [first_set, epsilon_in_first] = first(body);
-
-        if (epsilon_in_first) {
-          auto it = follow_sets.find(head);
-          if (it != follow_sets.end()) {
-            for (auto const &follow_terminal : it->second) {
-
-              auto [it2, has_inserted] = parsing_table.try_emplace(
-                  std::pair{follow_terminal, head}, body);
-              // not LL1
-              if (!has_inserted) {
-                std::cerr << std::format(
-                    "follow terminal {} confliction for production:\n {}",
-                    alphabet->to_string(follow_terminal),
-                    CFG_production(it2->first.second, it2->second)
-                        .to_string(*alphabet));
-                throw cyy::computation::exception::no_LL_grammar("");
-              }
-            }
-          }
-        }
-        for (auto const &terminal : first_set) {
+  LL_grammar::parsing_table_type LL_grammar::construct_parsing_table() const {
+    parsing_table_type table{.grammar = get_interned_grammar(), .entries = {}};
+    auto const &grammar = table.grammar;
+    auto const &grammar_sets = get_grammar_analysis();
+    for (size_t index = 0; index < grammar.get_production_number(); index++) {
+      auto const head = grammar.get_production(index).head;
+      auto const &body_first = grammar_sets.get_body_suffix_first(index, 0);
+      auto add_entries = [&](const grammar_analysis::terminal_bitset_type
+                                 &terminals,
+                             std::string_view reason) {
+        for (auto i = terminals.find_first();
+             i != grammar_analysis::terminal_bitset_type::npos;
+             i = terminals.find_next(i)) {
+          auto const terminal = grammar_sets.get_terminal(i);
           auto [it, has_inserted] =
-              parsing_table.try_emplace(std::pair{terminal, head}, body);
+              table.entries.try_emplace(std::pair{terminal, head}, index);
           // not LL1
           if (!has_inserted) {
             std::cerr << std::format(
-                "first terminal {} confliction for production:\n{}\n and "
+                "{} terminal {} confliction for production:\n{}\n and "
                 "production:\n{}",
-                alphabet->to_string(terminal),
-                CFG_production(it->first.second, it->second)
+                reason, alphabet->to_string(terminal),
+                grammar.get_original_production(it->second)
                     .to_string(*alphabet),
-                CFG_production(head, body).to_string(*alphabet));
+                grammar.get_original_production(index).to_string(*alphabet));
             throw cyy::computation::exception::no_LL_grammar("");
           }
         }
+      };
+      if (body_first.nullable) {
+        add_entries(grammar_sets.get_follow(head), "follow");
       }
+      add_entries(body_first.terminals, "first");
     }
+    return table;
   }
 
   bool LL_grammar::parse(
@@ -65,30 +58,32 @@ namespace cyy::computation {
       const std::function<void(const CFG_production &, std::size_t pos)>
           &match_callback) const {
 
-    if (parsing_table.empty()) {
-      construct_parsing_table();
-    }
-    using callback_argument_type =
-        std::pair<decltype(this->parsing_table)::const_iterator, std::size_t>;
+    auto const &table =
+        parsing_table.get([this] { return construct_parsing_table(); });
+    auto const &grammar = table.grammar;
+    // production index and position in its body
+    using callback_argument_type = std::pair<std::size_t, std::size_t>;
     // Stack holds symbols to match and pending callbacks, interleaved so each
     // callback fires only after its body symbol is parsed.
-    std::vector<std::variant<grammar_symbol_type, callback_argument_type>> stack;
-    stack.emplace_back(grammar_symbol_type(ALPHABET::endmarker));
-    stack.emplace_back(grammar_symbol_type(get_start_symbol()));
+    std::vector<std::variant<interned_symbol_type, callback_argument_type>>
+        stack;
+    stack.emplace_back(interned_symbol_type::terminal(ALPHABET::endmarker));
+    stack.emplace_back(
+        interned_symbol_type::nonterminal(interned_grammar::start_symbol));
 
     auto endmarked_view = cyy::algorithm::endmarked_symbol_string(view);
     auto terminal_it = endmarked_view.begin();
     while (!stack.empty()) {
-      auto top = std::move(stack.back());
+      auto top = stack.back();
       stack.pop_back();
 
       if (auto *argument = std::get_if<callback_argument_type>(&top)) {
-        auto const &[it, pos] = *argument;
-        match_callback({it->first.second, it->second}, pos);
+        auto const &[index, pos] = *argument;
+        match_callback(grammar.get_original_production(index), pos);
         continue;
       }
 
-      auto const &top_symbol = std::get<grammar_symbol_type>(top);
+      auto const top_symbol = std::get<interned_symbol_type>(top);
       auto terminal = *terminal_it;
       if (top_symbol.is_terminal()) {
         const auto s = top_symbol.get_terminal();
@@ -103,21 +98,23 @@ namespace cyy::computation {
       }
 
       auto nonterminal = top_symbol.get_nonterminal();
-      auto it = parsing_table.find({terminal, nonterminal});
-      if (it == parsing_table.end()) {
+      auto it = table.entries.find({terminal, nonterminal});
+      if (it == table.entries.end()) {
         std::cerr << std::format("no rule for parsing {} for {} \n",
-                                 alphabet->to_string(terminal), nonterminal);
+                                 alphabet->to_string(terminal),
+                                 grammar.get_name(nonterminal));
         return false;
       }
 
       // Push so callback(0) is on top: callback(n), X_n, ..., X_1, callback(0)
-      auto const &body = it->second;
-      stack.emplace_back(callback_argument_type{it, body.size()});
-      for (auto const &[index, symbol] :
+      auto const index = it->second;
+      auto const &body = grammar.get_production(index).body;
+      stack.emplace_back(callback_argument_type{index, body.size()});
+      for (auto const &[pos, symbol] :
            body | std::views::enumerate | std::views::reverse) {
         stack.emplace_back(symbol);
         stack.emplace_back(
-            callback_argument_type{it, static_cast<std::size_t>(index)});
+            callback_argument_type{index, static_cast<std::size_t>(pos)});
       }
     }
     assert(terminal_it == endmarked_view.end());
@@ -8,6 +8,7 @@
 #pragma once
 
 #include "cfg.hpp"
+#include "once_cache.hpp"
 
 namespace cyy::computation {
 
@@ -23,12 +24,17 @@ namespace cyy::computation {
     parse_node_ptr get_parse_tree(symbol_string_view view) const;
 
   private:
-    void construct_parsing_table() const;
+    //! Maps a lookahead terminal and a nonterminal ID to a production index
+    //! of the grammar, which is copied so that the table stays consistent
+    struct parsing_table_type {
+      interned_grammar grammar;
+      std::unordered_map<std::pair<CFG::terminal_type, nonterminal_id_type>,
+                         size_t>
+          entries;
+    };
+    parsing_table_type construct_parsing_table() const;
 
   private:
-    mutable std::unordered_map<
-        std::pair<CFG::terminal_type, CFG::nonterminal_type>,
-        const CFG_production::body_type &>
-        parsing_table;
+    once_cache<parsing_table_type> parsing_table;
   };
 } // namespace cyy::computation
@@ -8,13 +8,16 @@ namespace cyy::computation {
   std::unordered_set<LR_0_item>
   LR_0_item_set::expand_nonkernel_items(const CFG &cfg) const {
     std::unordered_set<LR_0_item> item_set;
+    auto const grammar_ptr = cfg.get_shared_interned_grammar();
+    auto const &grammar = *grammar_ptr;
     for (auto const &head : nonkernel_items) {
-      auto const &bodies = cfg.get_bodies(head);
-      for (auto const &body : bodies) {
-        if (body.empty()) {
+      auto const id = grammar.get_id(head);
+      assert(id.has_value());
+      for (auto const index : grammar.get_production_indices(*id)) {
+        if (grammar.get_production(index).body.empty()) {
           continue;
         }
-        item_set.emplace(head, body);
+        item_set.emplace(grammar_ptr, index);
       }
     }
     return item_set;
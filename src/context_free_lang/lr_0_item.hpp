@@ -8,6 +8,11 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstdint>
+#include <flat_set>
+#include <memory>
 
 #include <cyy/algorithm/hash.hpp>
 #include "cfg.hpp"
@@ -17,25 +22,37 @@
 namespace cyy::computation {
   class LR_0_item {
   public:
-    LR_0_item(CFG_production production, std::size_t dot_pos_ = 0)
-        : production_ptr{std::make_shared<CFG_production>(
-              std::move(production))},
-          dot_pos{dot_pos_} {}
-    LR_0_item(CFG_production::head_type head, CFG_production::body_type body,
-              std::size_t dot_pos_ = 0)
-        : LR_0_item(CFG_production{std::move(head), std::move(body)},
-                    dot_pos_) {}
+    //! An item of a production of the interned grammar of a CFG, it keeps
+    //! the grammar alive and is only compared with items of the same grammar.
+    LR_0_item(std::shared_ptr<const interned_grammar> grammar_,
+              std::size_t production_index_, std::size_t dot_pos_ = 0)
+        : grammar{std::move(grammar_)},
+          production_index{static_cast<uint32_t>(production_index_)},
+          dot_pos{static_cast<uint32_t>(dot_pos_)} {}
     LR_0_item(const LR_0_item &) = default;
     LR_0_item &operator=(const LR_0_item &) = default;
     LR_0_item(LR_0_item &&) = default;
     LR_0_item &operator=(LR_0_item &&) = default;
-    bool operator==(const LR_0_item &rhs) const {
-      return dot_pos == rhs.dot_pos && (production_ptr == rhs.production_ptr ||
-                                        *production_ptr == *rhs.production_ptr);
+    bool operator==(const LR_0_item &rhs) const noexcept {
+      assert(grammar == rhs.grammar);
+      return production_index == rhs.production_index &&
+             dot_pos == rhs.dot_pos;
+    }
+    std::strong_ordering operator<=>(const LR_0_item &rhs) const noexcept {
+      assert(grammar == rhs.grammar);
+      if (auto cmp = production_index <=> rhs.production_index; cmp != 0) {
+        return cmp;
+      }
+      return dot_pos <=> rhs.dot_pos;
+    }
+    auto const &get_head() const noexcept {
+      return get_production().get_head();
+    }
+    auto const &get_body() const noexcept {
+      return get_production().get_body();
     }
-    auto const &get_head() const noexcept { return production_ptr->get_head(); }
-    auto const &get_body() const noexcept { return production_ptr->get_body(); }
     std::size_t get_dot_pos() const noexcept { return dot_pos; }
+    auto get_production_index() const noexcept { return production_index; }
     bool completed() const noexcept { return dot_pos >= get_body().size(); }
     void go() {
       if (completed()) {
@@ -51,11 +68,14 @@ namespace cyy::computation {
     }
     [[nodiscard]] std::string MMA_draw(const CFG &cfg) const;
 
-    const CFG_production &get_production() const { return *production_ptr; }
+    const CFG_production &get_production() const {
+      return grammar->get_original_production(production_index);
+    }
 
   private:
-    std::shared_ptr<CFG_production> production_ptr;
-    std::size_t dot_pos;
+    std::shared_ptr<const interned_grammar> grammar;
+    uint32_t production_index;
+    uint32_t dot_pos;
   };
 
 } // namespace cyy::computation
@@ -64,7 +84,7 @@ namespace std {
     std::size_t
     operator()(const cyy::computation::LR_0_item &x) const noexcept {
       std::size_t seed = 0;
-      boost::hash_combine(seed, x.get_head());
+      boost::hash_combine(seed, x.get_production_index());
       boost::hash_combine(seed, x.get_dot_pos());
       return seed;
     }
@@ -75,14 +95,20 @@ namespace cyy::computation {
   public:
     void add_item(LR_0_item item) {
       if (item.get_dot_pos() == 0 && !item.completed()) {
-        nonkernel_items.insert(item.get_head());
+        add_nonkernel_item(item.get_head());
         return;
       }
-      kernel_items.emplace(std::move(item));
+      auto const item_hash = std::hash<LR_0_item>()(item);
+      if (kernel_items.insert(std::move(item)).second) {
+        content_hash += mix_hash(item_hash);
+      }
     }
 
     void add_nonkernel_item(const CFG_production::head_type &head) {
-      nonkernel_items.insert(head);
+      if (nonkernel_items.insert(head).second) {
+        content_hash +=
+            mix_hash(std::hash<CFG_production::head_type>()(head) ^ 1);
+      }
     }
 
     auto const &get_kernel_items() const noexcept { return kernel_items; }
@@ -98,25 +124,34 @@ namespace cyy::computation {
 
     std::unordered_set<LR_0_item> expand_nonkernel_items(const CFG &cfg) const;
 
+    //! The hashes differ first for most unequal sets
     bool operator==(const LR_0_item_set &rhs) const = default;
+    std::size_t get_hash() const noexcept { return content_hash; }
     bool empty() const noexcept {
       return kernel_items.empty() && nonkernel_items.empty();
     }
     [[nodiscard]] std::string MMA_draw(const CFG &cfg) const;
 
   private:
-    std::unordered_set<LR_0_item> kernel_items;
-    std::unordered_set<CFG_production::head_type> nonkernel_items;
+    static std::size_t mix_hash(std::size_t hash) noexcept {
+      hash ^= hash >> 33;
+      hash *= 0xff51afd7ed558ccdULL;
+      hash ^= hash >> 33;
+      return hash;
+    }
+
+    //! A sum of mixed item hashes, so it does not depend on the insertion
+    //! order and is updated in constant time
+    std::size_t content_hash{0};
+    std::flat_set<LR_0_item> kernel_items;
+    std::flat_set<CFG_production::head_type> nonkernel_items;
   };
 } // namespace cyy::computation
 namespace std {
   template <> struct hash<cyy::computation::LR_0_item_set> {
     std::size_t
     operator()(const cyy::computation::LR_0_item_set &x) const noexcept {
-      std::size_t seed = 0;
-      boost::hash_combine(seed, x.get_kernel_items().size());
-      boost::hash_combine(seed, x.get_nonkernel_items().size());
-      return seed;
+      return x.get_hash();
     }
   };
 } // namespace std
@@ -5,10 +5,12 @@
 
 #include "lr_1_grammar.hpp"
 
-#include "../exception.hpp"
+#include "exception.hpp"
+#include "instrumentation.hpp"
 
 namespace cyy::computation {
-  bool LR_1_grammar::DK_1_test(const collection_type &collection) const {
+  bool LR_1_grammar::DK_1_test(const CFG &cfg,
+                               const collection_type &collection) {
     for (const auto &[_, item_set] : collection) {
       if (!item_set.has_completed_items()) {
         continue;
@@ -22,7 +24,7 @@ namespace cyy::computation {
         }
         uncompleted_items.emplace_back(item);
       }
-      for (auto const &item : item_set.expand_nonkernel_items(*this)) {
+      for (auto const &item : item_set.expand_nonkernel_items(cfg)) {
         uncompleted_items.emplace_back(item);
       }
       for (auto it = completed_items.begin(); it != completed_items.end();
@@ -51,13 +53,40 @@ namespace cyy::computation {
   }
 
   void LR_1_grammar::construct_parsing_table() const {
-    const_cast<LR_1_grammar *>(this)->normalize_start_symbol();
+    static_cast<void>(get_parsing_table());
+  }
+
+  const LR_1_grammar::parsing_table_type &
+  LR_1_grammar::get_parsing_table() const {
+    return parsing_table.get([this] { return make_parsing_table(); });
+  }
+
+  LR_1_grammar::parsing_table_type LR_1_grammar::make_parsing_table() const {
+    auto const augmented_grammar = get_augmented_grammar();
     collection_type collection;
-    std::tie(collection, goto_table) = get_collection();
-    if (!DK_1_test(collection)) {
+    goto_table_type goto_table;
+    {
+      instrumentation::scoped_timer const timer(
+          instrumentation::counter::LR_1_collection_ns);
+      std::tie(collection, goto_table) = get_collection(augmented_grammar);
+    }
+    instrumentation::add(instrumentation::counter::LR_1_collection_state,
+                         collection.size());
+    if (!DK_1_test(augmented_grammar, collection)) {
       throw exception::no_LR_1_grammar("DK 1 test failed");
     }
+    instrumentation::scoped_timer const timer(
+        instrumentation::counter::LR_1_table_ns);
 
+    parsing_table_type table;
+    auto &[action_table, nonterminal_goto_table, reductions] = table;
+    // the tables use the IDs of the augmented grammar
+    auto const &grammar = augmented_grammar.get_interned_grammar();
+    auto get_id = [&grammar](const nonterminal_type &nonterminal) {
+      auto id = grammar.get_id(nonterminal);
+      assert(id.has_value());
+      return *id;
+    };
     for (auto const &[p, next_state] : goto_table) {
       assert(collection.contains(p.first));
       if (collection[p.first].empty()) {
@@ -69,8 +98,12 @@ namespace cyy::computation {
           continue;
         }
         action_table[{p.first, p.second.get_terminal()}] = next_state;
+      } else {
+        nonterminal_goto_table[{p.first, get_id(p.second.get_nonterminal())}] =
+            next_state;
       }
     }
+    std::unordered_map<CFG_production, size_t> reduction_indices;
     for (auto const &[state, set] : collection) {
       for (const auto &item : set.get_completed_items()) {
         for (const auto &lookahead : item.get_lookahead_symbols()) {
@@ -84,26 +117,33 @@ namespace cyy::computation {
                << it->second.index();
             throw cyy::computation::exception::no_LR_1_grammar(os.str());
           }
-          if (item.get_head() == get_start_symbol()) {
+          if (item.get_head() == augmented_grammar.get_start_symbol()) {
             assert(item.get_lookahead_symbols().size() == 1);
             assert(lookahead == ALPHABET::endmarker);
             action_table[{state, lookahead}] = true;
-          } else {
-            action_table[{state, lookahead}] = item.get_production();
+            continue;
+          }
+          auto [it2, has_emplaced] = reduction_indices.try_emplace(
+              item.get_production(), reductions.size());
+          if (has_emplaced) {
+            reductions.emplace_back(item.get_production(),
+                                    get_id(item.get_head()));
           }
+          action_table[{state, lookahead}] = reduction_index_type{it2->second};
         }
       }
     }
-    const_cast<LR_1_grammar *>(this)->remove_head(get_start_symbol());
+    instrumentation::add(instrumentation::counter::LR_1_table_entry,
+                         action_table.size());
+    return table;
   }
   bool
   LR_1_grammar::parse(symbol_string_view view,
                       const std::function<void(terminal_type)> &shift_callback,
                       const std::function<void(const CFG_production &)>
                           &reduction_callback) const {
-    if (action_table.empty() || goto_table.empty()) {
-      construct_parsing_table();
-    }
+    auto const &[action_table, nonterminal_goto_table, reductions] =
+        get_parsing_table();
 
     std::vector<state_type> stack{0};
 
@@ -126,26 +166,22 @@ namespace cyy::computation {
 
       if (std::holds_alternative<state_type>(it->second)) {
         // shift
-        /* std::cerr << "shift for state " << stack.back() << " and terminal "
-         */
-        /*           << alphabet->to_string(terminal); */
         stack.push_back(std::get<state_type>(it->second));
-        /* std::cerr << " to state " << stack.back() << std::endl; */
         shift_callback(terminal);
         ++terminal_it;
         continue;
       }
 
-      auto const &production = std::get<CFG_production>(it->second);
       // reduce
-      auto const &head = std::get<CFG_production>(it->second).get_head();
-      auto const &body = std::get<CFG_production>(it->second).get_body();
-      reduction_callback(production);
+      auto const &reduction =
+          reductions[std::get<reduction_index_type>(it->second).index];
+      reduction_callback(reduction.production);
 
-      stack.resize(stack.size() - body.size());
-      auto it2 = goto_table.find({stack.back(), head});
-      if (it2 == goto_table.end()) {
-        std::cerr << "goto table no find for head:" << head << '\n';
+      stack.resize(stack.size() - reduction.production.get_body().size());
+      auto it2 = nonterminal_goto_table.find({stack.back(), reduction.head});
+      if (it2 == nonterminal_goto_table.end()) {
+        std::cerr << "goto table no find for head:"
+                  << reduction.production.get_head() << '\n';
         return false;
       }
       stack.push_back(it2->second);
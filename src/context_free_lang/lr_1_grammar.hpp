@@ -8,6 +8,7 @@
 #include "dk_1.hpp"
 #include "lr_1_item.hpp"
 #include "lr_grammar.hpp"
+#include "once_cache.hpp"
 
 namespace cyy::computation {
 
@@ -16,21 +17,74 @@ namespace cyy::computation {
   public:
     using LR_grammar::LR_grammar;
     using collection_type = DK_1_DFA::LR_1_item_set_collection_type;
+    std::pair<collection_type, goto_table_type> get_collection() const {
+      return get_collection(*this);
+    }
+    //! The collection of cfg by the construction of this grammar type, the
+    //! parsing tables pass an augmented copy of this grammar
     virtual std::pair<collection_type, goto_table_type>
-    get_collection() const = 0;
+    get_collection(const CFG &cfg) const = 0;
 
+    //! The parsing table is built once by the first parse from an augmented
+    //! copy of the grammar, so concurrent parses are safe.
     [[nodiscard]] bool
     parse(symbol_string_view view,
           const std::function<void(terminal_type)> &shift_callback,
           const std::function<void(const CFG_production &)> &reduction_callback)
         const override;
 
+    //! Generalized LR parsing with the same collection. Conflicting actions
+    //! are all followed on a graph-structured stack whose edges share the
+    //! parse trees of their symbols, so ambiguous grammars are accepted and
+    //! one of the parse trees is returned.
+    parse_node_ptr get_GLR_parse_tree(symbol_string_view view) const;
+    [[nodiscard]] bool GLR_parse(symbol_string_view view) const {
+      return get_GLR_parse_tree(view) != nullptr;
+    }
+
   private:
-    bool DK_1_test(const collection_type &collection) const;
+    struct reduction_type {
+      CFG_production production;
+      nonterminal_id_type head;
+    };
+    //! index into reductions
+    struct reduction_index_type {
+      size_t index;
+    };
+    //! Nonterminals are interned, so parsing only hashes integers
+    using action_table_type = std::unordered_map<
+        std::pair<state_type, terminal_type>,
+        std::variant<state_type, reduction_index_type, bool>>;
+    using nonterminal_goto_table_type =
+        std::unordered_map<std::pair<state_type, nonterminal_id_type>,
+                           state_type>;
+
+    struct parsing_table_type {
+      action_table_type action_table;
+      nonterminal_goto_table_type nonterminal_goto_table;
+      std::vector<reduction_type> reductions;
+    };
+
+    //! Conflicts are kept, the start symbol is only accepted
+    struct GLR_table_type {
+      std::unordered_map<std::pair<state_type, terminal_type>, state_type>
+          shifts;
+      std::unordered_map<std::pair<state_type, terminal_type>,
+                         std::vector<size_t>>
+          reduction_indices;
+      std::unordered_set<state_type> accepting_states;
+      nonterminal_goto_table_type nonterminal_goto_table;
+      std::vector<reduction_type> reductions;
+    };
+
+    static bool DK_1_test(const CFG &cfg, const collection_type &collection);
     void construct_parsing_table() const override;
+    const parsing_table_type &get_parsing_table() const;
+    parsing_table_type make_parsing_table() const;
+    GLR_table_type make_GLR_table() const;
 
   private:
-    mutable action_table_type action_table;
-    mutable goto_table_type goto_table;
+    once_cache<parsing_table_type> parsing_table;
+    once_cache<GLR_table_type> GLR_table;
   };
 } // namespace cyy::computation
@@ -0,0 +1,200 @@
+/*!
+ * \file lr_1_grammar_glr_parse.cpp
+ *
+ * \brief generalized LR parsing on a graph-structured stack
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <deque>
+
+#include "instrumentation.hpp"
+#include "lr_1_grammar.hpp"
+
+namespace cyy::computation {
+  namespace {
+    struct GSS_node;
+    //! An edge to the node below, labeled with the tree of its symbol
+    struct GSS_edge {
+      GSS_node *to;
+      CFG::parse_node_ptr label;
+    };
+    struct GSS_node {
+      LR_1_grammar::state_type state;
+      std::vector<GSS_edge> edges;
+      bool has_edge_to(const GSS_node *node) const {
+        return std::ranges::any_of(
+            edges, [node](auto const &edge) { return edge.to == node; });
+      }
+    };
+
+    //! Calls fun with the end node and the labels of every path of length
+    //! from node, the labels are in symbol order
+    template <typename F>
+    void for_each_path(GSS_node *node, size_t length,
+                       std::vector<CFG::parse_node_ptr> &labels, F &&fun) {
+      if (length == 0) {
+        fun(node, std::vector<CFG::parse_node_ptr>(labels.rbegin(),
+                                                   labels.rend()));
+        return;
+      }
+      for (size_t i = 0; i < node->edges.size(); i++) {
+        // the edges of a node may grow while its paths are visited
+        auto const edge = node->edges[i];
+        labels.push_back(edge.label);
+        for_each_path(edge.to, length - 1, labels, fun);
+        labels.pop_back();
+      }
+    }
+  } // namespace
+
+  LR_1_grammar::GLR_table_type LR_1_grammar::make_GLR_table() const {
+    auto const augmented_grammar = get_augmented_grammar();
+    auto [collection, goto_table] = get_collection(augmented_grammar);
+    instrumentation::add(instrumentation::counter::LR_1_collection_state,
+                         collection.size());
+
+    GLR_table_type table;
+    auto const &grammar = augmented_grammar.get_interned_grammar();
+    auto get_id = [&grammar](const nonterminal_type &nonterminal) {
+      auto id = grammar.get_id(nonterminal);
+      assert(id.has_value());
+      return *id;
+    };
+    for (auto const &[p, next_state] : goto_table) {
+      if (collection[p.first].empty()) {
+        continue;
+      }
+      if (p.second.is_terminal()) {
+        if (collection[next_state].empty()) {
+          continue;
+        }
+        table.shifts[{p.first, p.second.get_terminal()}] = next_state;
+      } else {
+        table.nonterminal_goto_table[{p.first,
+                                      get_id(p.second.get_nonterminal())}] =
+            next_state;
+      }
+    }
+    std::unordered_map<CFG_production, size_t> reduction_indices;
+    for (auto const &[state, set] : collection) {
+      for (const auto &item : set.get_completed_items()) {
+        if (item.get_head() == augmented_grammar.get_start_symbol()) {
+          table.accepting_states.insert(state);
+          continue;
+        }
+        auto [it, has_emplaced] = reduction_indices.try_emplace(
+            item.get_production(), table.reductions.size());
+        if (has_emplaced) {
+          table.reductions.emplace_back(item.get_production(),
+                                        get_id(item.get_head()));
+        }
+        for (const auto &lookahead : item.get_lookahead_symbols()) {
+          table.reduction_indices[{state, lookahead}].push_back(it->second);
+        }
+      }
+    }
+    return table;
+  }
+
+  LR_grammar::parse_node_ptr
+  LR_1_grammar::get_GLR_parse_tree(symbol_string_view view) const {
+    instrumentation::add(instrumentation::counter::GLR_parse);
+    auto const &table = GLR_table.get([this] { return make_GLR_table(); });
+
+    std::deque<GSS_node> nodes;
+    auto add_node = [&nodes](state_type state) {
+      instrumentation::add(instrumentation::counter::GLR_stack_node);
+      return &nodes.emplace_back(GSS_node{.state = state, .edges = {}});
+    };
+    // the nodes of the current input position, at most one per state
+    std::vector<GSS_node *> frontier{add_node(0)};
+    auto find_frontier_node = [&frontier](state_type state) -> GSS_node * {
+      auto it = std::ranges::find(frontier, state, &GSS_node::state);
+      return it == frontier.end() ? nullptr : *it;
+    };
+
+    auto endmarked_view = cyy::algorithm::endmarked_symbol_string(view);
+    for (auto const terminal : endmarked_view) {
+      // Reduce until no new node or edge appears. A new edge to a processed
+      // node may complete paths of any processed node through nullable
+      // reductions, so all of them are reduced again.
+      std::vector<GSS_node *> pending = frontier;
+      while (!pending.empty()) {
+        auto *node = pending.back();
+        pending.pop_back();
+        auto it = table.reduction_indices.find({node->state, terminal});
+        if (it == table.reduction_indices.end()) {
+          continue;
+        }
+        for (auto const index : it->second) {
+          auto const &reduction = table.reductions[index];
+          std::vector<parse_node_ptr> labels;
+          for_each_path(
+              node, reduction.production.get_body().size(), labels,
+              [&](GSS_node *end_node, std::vector<parse_node_ptr> children) {
+                auto goto_it = table.nonterminal_goto_table.find(
+                    {end_node->state, reduction.head});
+                if (goto_it == table.nonterminal_goto_table.end()) {
+                  return;
+                }
+                auto *target = find_frontier_node(goto_it->second);
+                if (target != nullptr && target->has_edge_to(end_node)) {
+                  // another derivation of the same symbol and span
+                  return;
+                }
+                auto label = std::make_shared<parse_node>(
+                    reduction.production.get_head());
+                label->children = std::move(children);
+                if (target == nullptr) {
+                  target = add_node(goto_it->second);
+                  frontier.push_back(target);
+                  target->edges.emplace_back(end_node, std::move(label));
+                  pending.push_back(target);
+                  return;
+                }
+                target->edges.emplace_back(end_node, std::move(label));
+                for (auto *frontier_node : frontier) {
+                  if (!std::ranges::contains(pending, frontier_node)) {
+                    pending.push_back(frontier_node);
+                  }
+                }
+              });
+        }
+      }
+
+      if (terminal == ALPHABET::endmarker) {
+        for (auto *node : frontier) {
+          if (table.accepting_states.contains(node->state)) {
+            // the only path below an accepting state is the start symbol
+            return node->edges.front().label;
+          }
+        }
+        return {};
+      }
+
+      std::vector<GSS_node *> next_frontier;
+      auto const leaf = std::make_shared<parse_node>(terminal);
+      for (auto *node : frontier) {
+        auto it = table.shifts.find({node->state, terminal});
+        if (it == table.shifts.end()) {
+          continue;
+        }
+        auto next_it =
+            std::ranges::find(next_frontier, it->second, &GSS_node::state);
+        auto *next_node =
+            next_it == next_frontier.end() ? nullptr : *next_it;
+        if (next_node == nullptr) {
+          next_node = add_node(it->second);
+          next_frontier.push_back(next_node);
+        }
+        next_node->edges.emplace_back(node, leaf);
+      }
+      if (next_frontier.empty()) {
+        return {};
+      }
+      frontier = std::move(next_frontier);
+    }
+    return {};
+  }
+} // namespace cyy::computation
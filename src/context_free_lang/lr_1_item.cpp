@@ -64,13 +64,16 @@ namespace cyy::computation {
   std::unordered_set<LR_1_item>
   LR_1_item_set::expand_nonkernel_items(const CFG &cfg) const {
     std::unordered_set<LR_1_item> item_set;
+    auto const grammar_ptr = cfg.get_shared_interned_grammar();
+    auto const &grammar = *grammar_ptr;
     for (auto const &[head, lookahead_symbols] : nonkernel_items) {
-      auto const &bodies = cfg.get_bodies(head);
-      for (auto const &body : bodies) {
-        if (body.empty()) {
+      auto const id = grammar.get_id(head);
+      assert(id.has_value());
+      for (auto const index : grammar.get_production_indices(*id)) {
+        if (grammar.get_production(index).body.empty()) {
           continue;
         }
-        item_set.emplace(LR_0_item{head, body}, lookahead_symbols);
+        item_set.emplace(LR_0_item{grammar_ptr, index}, lookahead_symbols);
       }
     }
     return item_set;
@@ -29,9 +29,6 @@ namespace cyy::computation {
         const = 0;
 
   protected:
-    using action_table_type =
-        std::unordered_map<std::pair<state_type, terminal_type>,
-                           std::variant<state_type, CFG_production, bool>>;
     using goto_table_type =
         std::unordered_map<std::pair<state_type, grammar_symbol_type>,
                            state_type>;
@@ -0,0 +1,240 @@
+/*!
+ * \file minimal_lr_grammar.cpp
+ *
+ * \brief Pager's minimal LR(1) collection with weak compatibility
+ */
+
+#include "minimal_lr_grammar.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <optional>
+
+#include <boost/container_hash/hash.hpp>
+
+namespace cyy::computation {
+  namespace {
+    using terminal_bitset_type = grammar_analysis::terminal_bitset_type;
+
+    //! Two states with the same core are weakly compatible if every pair of
+    //! their kernel items that would share a lookahead after the merge
+    //! already shares one in either state.
+    bool weakly_compatible(const std::vector<terminal_bitset_type> &lhs,
+                           const std::vector<terminal_bitset_type> &rhs) {
+      for (size_t i = 0; i < lhs.size(); i++) {
+        for (size_t j = i + 1; j < lhs.size(); j++) {
+          if ((lhs[i].intersects(rhs[j]) || rhs[i].intersects(lhs[j])) &&
+              !lhs[i].intersects(lhs[j]) && !rhs[i].intersects(rhs[j])) {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+  } // namespace
+
+  std::pair<minimal_LR_grammar::collection_type,
+            minimal_LR_grammar::goto_table_type>
+  minimal_LR_grammar::get_collection(const CFG &cfg) const {
+    auto const grammar_ptr = cfg.get_shared_interned_grammar();
+    auto const &grammar = *grammar_ptr;
+    auto const &analysis = cfg.get_grammar_analysis();
+    // an item is the offset of its production plus its dot
+    using kernel_type = std::vector<uint32_t>;
+    struct kernel_hash {
+      size_t operator()(const kernel_type &kernel) const noexcept {
+        return boost::hash_range(kernel.begin(), kernel.end());
+      }
+    };
+    std::vector<uint32_t> item_offsets;
+    std::vector<uint32_t> item_productions;
+    for (size_t index = 0; index < grammar.get_production_number(); index++) {
+      item_offsets.push_back(static_cast<uint32_t>(item_productions.size()));
+      item_productions.insert(item_productions.end(),
+                              grammar.get_production(index).body.size() + 1,
+                              static_cast<uint32_t>(index));
+    }
+
+    struct state_info {
+      //! sorted items
+      kernel_type kernel;
+      //! the lookaheads of the kernel items
+      std::vector<terminal_bitset_type> lookaheads;
+      std::vector<std::pair<interned_symbol_type, state_type>> transitions;
+    };
+    std::vector<state_info> states;
+    std::unordered_map<kernel_type, std::vector<state_type>, kernel_hash>
+        core_states;
+
+    // the kernel followed by the nonkernel items with their lookaheads
+    auto closure = [&](const state_info &state) {
+      auto items = state.kernel;
+      auto lookaheads = state.lookaheads;
+      std::unordered_map<uint32_t, size_t> item_indices;
+      std::vector<size_t> pending;
+      for (size_t i = 0; i < items.size(); i++) {
+        item_indices.emplace(items[i], i);
+        pending.push_back(i);
+      }
+      while (!pending.empty()) {
+        auto const i = pending.back();
+        pending.pop_back();
+        auto const index = item_productions[items[i]];
+        auto const dot = items[i] - item_offsets[index];
+        auto const &body = grammar.get_production(index).body;
+        if (dot == body.size() || body[dot].is_terminal()) {
+          continue;
+        }
+        auto const &suffix_first =
+            analysis.get_body_suffix_first(index, dot + 1);
+        auto predicted_lookaheads = suffix_first.terminals;
+        if (suffix_first.nullable) {
+          predicted_lookaheads |= lookaheads[i];
+        }
+        for (auto const production_index :
+             grammar.get_production_indices(body[dot].get_nonterminal())) {
+          auto [it, has_emplaced] = item_indices.try_emplace(
+              item_offsets[production_index], items.size());
+          if (has_emplaced) {
+            items.push_back(item_offsets[production_index]);
+            lookaheads.push_back(predicted_lookaheads);
+            pending.push_back(it->second);
+          } else if (!predicted_lookaheads.is_subset_of(
+                         lookaheads[it->second])) {
+            lookaheads[it->second] |= predicted_lookaheads;
+            pending.push_back(it->second);
+          }
+        }
+      }
+      return std::pair{std::move(items), std::move(lookaheads)};
+    };
+
+    std::vector<bool> queued;
+    std::deque<state_type> queue;
+    auto add_state = [&](kernel_type kernel,
+                         std::vector<terminal_bitset_type> lookaheads) {
+      auto &candidates = core_states[kernel];
+      for (auto const candidate : candidates) {
+        auto &state = states[candidate];
+        if (!weakly_compatible(state.lookaheads, lookaheads)) {
+          continue;
+        }
+        bool changed = false;
+        for (size_t i = 0; i < lookaheads.size(); i++) {
+          if (!lookaheads[i].is_subset_of(state.lookaheads[i])) {
+            state.lookaheads[i] |= lookaheads[i];
+            changed = true;
+          }
+        }
+        // the successors are generated again with the new lookaheads
+        if (changed && !queued[candidate]) {
+          queued[candidate] = true;
+          queue.push_back(candidate);
+        }
+        return candidate;
+      }
+      auto const new_state = static_cast<state_type>(states.size());
+      candidates.push_back(new_state);
+      states.emplace_back(std::move(kernel), std::move(lookaheads));
+      queued.push_back(true);
+      queue.push_back(new_state);
+      return new_state;
+    };
+
+    {
+      kernel_type kernel;
+      for (auto const index :
+           grammar.get_production_indices(interned_grammar::start_symbol)) {
+        kernel.push_back(item_offsets[index]);
+      }
+      terminal_bitset_type endmarker(analysis.get_terminal_number());
+      endmarker.set(*analysis.get_terminal_index(ALPHABET::endmarker));
+      std::vector<terminal_bitset_type> lookaheads(kernel.size(), endmarker);
+      add_state(std::move(kernel), std::move(lookaheads));
+    }
+    while (!queue.empty()) {
+      auto const state = queue.front();
+      queue.pop_front();
+      queued[state] = false;
+      auto [items, lookaheads] = closure(states[state]);
+      // the goto kernels in symbol order, each item is paired with the index
+      // of the item it advances
+      using goto_items_type = std::vector<std::pair<uint32_t, size_t>>;
+      std::map<std::pair<bool, uint64_t>,
+               std::pair<interned_symbol_type, goto_items_type>>
+          goto_kernels;
+      for (size_t i = 0; i < items.size(); i++) {
+        auto const index = item_productions[items[i]];
+        auto const dot = items[i] - item_offsets[index];
+        auto const &body = grammar.get_production(index).body;
+        if (dot == body.size()) {
+          continue;
+        }
+        auto const &symbol = body[dot];
+        auto const key =
+            symbol.is_terminal()
+                ? std::pair{true, static_cast<uint64_t>(symbol.get_terminal())}
+                : std::pair{false,
+                            static_cast<uint64_t>(symbol.get_nonterminal())};
+        auto it =
+            goto_kernels.try_emplace(key, symbol, goto_items_type{}).first;
+        it->second.second.emplace_back(items[i] + 1, i);
+      }
+      std::vector<std::pair<interned_symbol_type, state_type>> transitions;
+      for (auto &[_, p] : goto_kernels) {
+        auto &[symbol, kernel_items] = p;
+        std::ranges::sort(kernel_items);
+        kernel_type kernel;
+        std::vector<terminal_bitset_type> kernel_lookaheads;
+        for (auto const &[item, i] : kernel_items) {
+          kernel.push_back(item);
+          kernel_lookaheads.push_back(lookaheads[i]);
+        }
+        transitions.emplace_back(
+            symbol, add_state(std::move(kernel), std::move(kernel_lookaheads)));
+      }
+      states[state].transitions = std::move(transitions);
+    }
+
+    // A state whose predecessors all moved to other states after their
+    // lookaheads grew is unreachable, the others are numbered breadth-first.
+    std::vector<std::optional<state_type>> state_map(states.size());
+    std::vector<state_type> reachable_states{0};
+    state_map[0] = 0;
+    for (size_t i = 0; i < reachable_states.size(); i++) {
+      for (auto const &[_, next_state] :
+           states[reachable_states[i]].transitions) {
+        if (!state_map[next_state].has_value()) {
+          state_map[next_state] =
+              static_cast<state_type>(reachable_states.size());
+          reachable_states.push_back(next_state);
+        }
+      }
+    }
+
+    collection_type collection;
+    goto_table_type goto_table;
+    for (auto const state : reachable_states) {
+      auto const new_state = *state_map[state];
+      auto [items, lookaheads] = closure(states[state]);
+      auto &item_set = collection[new_state];
+      for (size_t i = 0; i < items.size(); i++) {
+        auto const index = item_productions[items[i]];
+        item_set.add_item(LR_1_item(
+            LR_0_item(grammar_ptr, index, items[i] - item_offsets[index]),
+            analysis.to_terminal_set(lookaheads[i])));
+      }
+      for (auto const &[symbol, next_state] : states[state].transitions) {
+        grammar_symbol_type grammar_symbol =
+            symbol.is_terminal()
+                ? grammar_symbol_type(symbol.get_terminal())
+                : grammar_symbol_type(
+                      grammar.get_name(symbol.get_nonterminal()));
+        goto_table.emplace(std::pair{new_state, std::move(grammar_symbol)},
+                           *state_map[next_state]);
+      }
+    }
+    return {collection, goto_table};
+  }
+} // namespace cyy::computation
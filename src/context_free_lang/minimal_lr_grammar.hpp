@@ -0,0 +1,25 @@
+/*!
+ * \file minimal_lr_grammar.hpp
+ *
+ * \brief LR(1) parsing with Pager's minimal LR(1) collection
+ */
+
+#pragma once
+
+#include "lr_1_grammar.hpp"
+
+namespace cyy::computation {
+
+  //! Accepts the same grammars as canonical LR(1). States with the same
+  //! LR(0) core are merged when they are weakly compatible in Pager's sense,
+  //! such a merge never introduces a conflict, so the collection is usually
+  //! as small as the LALR(1) one.
+  class minimal_LR_grammar final : public LR_1_grammar {
+  public:
+    using LR_1_grammar::LR_1_grammar;
+    using LR_1_grammar::get_collection;
+
+    std::pair<collection_type, goto_table_type>
+    get_collection(const CFG &cfg) const override;
+  };
+} // namespace cyy::computation
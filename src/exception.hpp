@@ -44,6 +44,14 @@ namespace cyy::computation::exception {
   public:
     using invalid_argument::invalid_argument;
   };
+  class invalid_automaton_binary : public std::invalid_argument {
+  public:
+    using invalid_argument::invalid_argument;
+  };
+  class unsorted_strings : public std::invalid_argument {
+  public:
+    using invalid_argument::invalid_argument;
+  };
 
   class no_CFG : public std::invalid_argument {
   public:
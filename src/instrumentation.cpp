@@ -0,0 +1,85 @@
+/*!
+ * \file instrumentation.cpp
+ *
+ * \brief optional counters of automaton and grammar operations
+ */
+
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <format>
+#include <mutex>
+#include <vector>
+
+namespace cyy::computation::instrumentation {
+  namespace {
+    struct counter_registry {
+      std::mutex mutex;
+      std::vector<detail::thread_counters *> live_counters;
+      //! counters of exited threads
+      counter_values retired_values;
+    };
+    counter_registry &get_registry() {
+      static counter_registry registry;
+      return registry;
+    }
+  } // namespace
+
+  std::string counter_values::to_json() const {
+    std::string json = "{";
+    for (size_t i = 0; i < counter_number; i++) {
+      if (i != 0) {
+        json += ',';
+      }
+      json += std::format("\"{}\":{}", counter_names[i], values[i]);
+    }
+    json += '}';
+    return json;
+  }
+
+  namespace detail {
+    thread_counters::thread_counters() {
+      auto &registry = get_registry();
+      std::lock_guard lock(registry.mutex);
+      registry.live_counters.push_back(this);
+    }
+    thread_counters::~thread_counters() {
+      auto &registry = get_registry();
+      std::lock_guard lock(registry.mutex);
+      registry.retired_values += load();
+      std::erase(registry.live_counters, this);
+    }
+    counter_values thread_counters::load() const noexcept {
+      counter_values result;
+      for (size_t i = 0; i < counter_number; i++) {
+        result.values[i] = values[i].load(std::memory_order_relaxed);
+      }
+      return result;
+    }
+  } // namespace detail
+
+  counter_values get_thread_counters() {
+    return detail::get_local_counters().load();
+  }
+
+  counter_values get_global_counters() {
+    auto &registry = get_registry();
+    std::lock_guard lock(registry.mutex);
+    auto result = registry.retired_values;
+    for (auto const *counters : registry.live_counters) {
+      result += counters->load();
+    }
+    return result;
+  }
+
+  void reset() {
+    auto &registry = get_registry();
+    std::lock_guard lock(registry.mutex);
+    registry.retired_values = {};
+    for (auto *counters : registry.live_counters) {
+      for (auto &value : counters->values) {
+        value.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+} // namespace cyy::computation::instrumentation
@@ -0,0 +1,155 @@
+/*!
+ * \file instrumentation.hpp
+ *
+ * \brief optional counters of automaton and grammar operations
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace cyy::computation::instrumentation {
+  //! Counting is compiled in by defining CYY_COMPUTATION_INSTRUMENTATION (the
+  //! ENABLE_INSTRUMENTATION CMake option), otherwise all hooks are empty.
+#ifdef CYY_COMPUTATION_INSTRUMENTATION
+  inline constexpr bool enabled = true;
+#else
+  inline constexpr bool enabled = false;
+#endif
+
+  enum class counter : uint8_t {
+    NFA_step,
+    NFA_transition_lookup,
+    NFA_epsilon_closure_lookup,
+    NFA_epsilon_closure_computation,
+    subset_construction_state,
+    DFA_step,
+    DFA_transition_lookup,
+    DFA_live_state_computation,
+    DFA_minimization_round,
+    regex_parse,
+    regex_to_DFA_state,
+    first_set_cache_hit,
+    first_set_cache_miss,
+    LR_1_collection_ns,
+    LR_1_collection_state,
+    LR_1_table_ns,
+    LR_1_table_entry,
+    CNF_parse,
+    CNF_cell_merge,
+    Earley_parse,
+    Earley_item,
+    GLR_parse,
+    GLR_stack_node,
+  };
+  inline constexpr size_t counter_number =
+      static_cast<size_t>(counter::GLR_stack_node) + 1;
+  inline constexpr std::array<std::string_view, counter_number> counter_names{
+      "NFA_step",
+      "NFA_transition_lookup",
+      "NFA_epsilon_closure_lookup",
+      "NFA_epsilon_closure_computation",
+      "subset_construction_state",
+      "DFA_step",
+      "DFA_transition_lookup",
+      "DFA_live_state_computation",
+      "DFA_minimization_round",
+      "regex_parse",
+      "regex_to_DFA_state",
+      "first_set_cache_hit",
+      "first_set_cache_miss",
+      "LR_1_collection_ns",
+      "LR_1_collection_state",
+      "LR_1_table_ns",
+      "LR_1_table_entry",
+      "CNF_parse",
+      "CNF_cell_merge",
+      "Earley_parse",
+      "Earley_item",
+      "GLR_parse",
+      "GLR_stack_node",
+  };
+
+  struct counter_values {
+    std::array<uint64_t, counter_number> values{};
+
+    uint64_t operator[](counter c) const noexcept {
+      return values[static_cast<size_t>(c)];
+    }
+    counter_values &operator+=(const counter_values &rhs) noexcept {
+      for (size_t i = 0; i < counter_number; i++) {
+        values[i] += rhs.values[i];
+      }
+      return *this;
+    }
+    //! One JSON object mapping counter names to values
+    std::string to_json() const;
+  };
+
+  namespace detail {
+    //! Written only by the owning thread, atomics let other threads
+    //! aggregate without data races.
+    struct thread_counters {
+      thread_counters();
+      thread_counters(const thread_counters &) = delete;
+      thread_counters &operator=(const thread_counters &) = delete;
+      thread_counters(thread_counters &&) = delete;
+      thread_counters &operator=(thread_counters &&) = delete;
+      ~thread_counters();
+      counter_values load() const noexcept;
+
+      std::array<std::atomic<uint64_t>, counter_number> values{};
+    };
+    inline thread_counters &get_local_counters() {
+      thread_local thread_counters counters;
+      return counters;
+    }
+  } // namespace detail
+
+  inline void add(counter c, uint64_t n = 1) noexcept {
+    if constexpr (enabled) {
+      auto &value =
+          detail::get_local_counters().values[static_cast<size_t>(c)];
+      value.store(value.load(std::memory_order_relaxed) + n,
+                  std::memory_order_relaxed);
+    }
+  }
+
+  //! Counters of the calling thread
+  counter_values get_thread_counters();
+  //! Counters summed over live and exited threads
+  counter_values get_global_counters();
+  //! Zero the counters of all threads
+  void reset();
+
+  //! Add the elapsed nanoseconds to a counter when the scope ends
+  class scoped_timer {
+  public:
+    explicit scoped_timer(counter c_) noexcept : c(c_) {
+      if constexpr (enabled) {
+        begin = std::chrono::steady_clock::now();
+      }
+    }
+    scoped_timer(const scoped_timer &) = delete;
+    scoped_timer &operator=(const scoped_timer &) = delete;
+    scoped_timer(scoped_timer &&) = delete;
+    scoped_timer &operator=(scoped_timer &&) = delete;
+    ~scoped_timer() {
+      if constexpr (enabled) {
+        add(c, static_cast<uint64_t>(
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count()));
+      }
+    }
+
+  private:
+    counter c;
+    std::chrono::steady_clock::time_point begin;
+  };
+} // namespace cyy::computation::instrumentation
@@ -0,0 +1,65 @@
+/*!
+ * \file once_cache.hpp
+ *
+ * \brief a lazily computed value safe for concurrent const access
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace cyy::computation {
+  //! The value is computed at most once between resets, readers after the
+  //! first computation only do an atomic load. Resetting is a mutation and
+  //! must not race with readers.
+  template <typename T> class once_cache {
+  public:
+    once_cache() = default;
+    once_cache(const once_cache &rhs) : value(rhs.value.load()) {}
+    once_cache &operator=(const once_cache &rhs) {
+      if (this != &rhs) {
+        value.store(rhs.value.load());
+      }
+      return *this;
+    }
+    once_cache(once_cache &&rhs) noexcept : value(rhs.value.exchange({})) {}
+    once_cache &operator=(once_cache &&rhs) noexcept {
+      if (this != &rhs) {
+        value.store(rhs.value.exchange({}));
+      }
+      return *this;
+    }
+    ~once_cache() = default;
+
+    template <typename F> const T &get(F &&compute) const {
+      return *get_shared(std::forward<F>(compute));
+    }
+    //! The cached value stays alive while the returned pointer does, even
+    //! after a reset
+    template <typename F>
+    std::shared_ptr<const T> get_shared(F &&compute) const {
+      auto ptr = value.load(std::memory_order_acquire);
+      if (ptr) {
+        return ptr;
+      }
+      std::lock_guard lock(mutex);
+      ptr = value.load(std::memory_order_acquire);
+      if (!ptr) {
+        ptr = std::make_shared<const T>(std::forward<F>(compute)());
+        value.store(ptr, std::memory_order_release);
+      }
+      return ptr;
+    }
+    bool has_value() const noexcept {
+      return value.load(std::memory_order_acquire) != nullptr;
+    }
+    void reset() noexcept { value.store({}); }
+
+  private:
+    // cached values are immutable, so copies of the cache share them
+    mutable std::atomic<std::shared_ptr<const T>> value;
+    mutable std::mutex mutex;
+  };
+} // namespace cyy::computation
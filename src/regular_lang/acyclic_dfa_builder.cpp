@@ -0,0 +1,261 @@
+/*!
+ * \file acyclic_dfa_builder.cpp
+ *
+ * \brief incremental construction of minimal acyclic DFAs
+ */
+
+#include "acyclic_dfa_builder.hpp"
+
+#include <algorithm>
+
+namespace cyy::computation {
+  acyclic_DFA_builder::acyclic_DFA_builder(ALPHABET_ptr alphabet_)
+      : alphabet(std::move(alphabet_)), nodes(1), sorted_path{root} {}
+
+  void acyclic_DFA_builder::check_symbols(symbol_string_view str) const {
+    for (auto const a : str) {
+      if (!alphabet->contain(a)) {
+        throw exception::unmatched_alphabets(
+            std::string("alphabet [") + alphabet->get_name() +
+            "] does not contain symbol " + alphabet->to_string(a));
+      }
+    }
+  }
+
+  std::optional<acyclic_DFA_builder::state_type>
+  acyclic_DFA_builder::go(state_type s, symbol_type a) const noexcept {
+    auto const &edges = nodes[s].edges;
+    auto it = std::ranges::lower_bound(edges, a, {},
+                                       &std::pair<symbol_type, state_type>::first);
+    if (it == edges.end() || it->first != a) {
+      return {};
+    }
+    return it->second;
+  }
+
+  acyclic_DFA_builder::state_type acyclic_DFA_builder::new_state() {
+    if (!free_states.empty()) {
+      auto const s = free_states.back();
+      free_states.pop_back();
+      return s;
+    }
+    nodes.emplace_back();
+    return static_cast<state_type>(nodes.size() - 1);
+  }
+
+  void acyclic_DFA_builder::delete_state(state_type s) {
+    for (auto const &[_, next_state] : nodes[s].edges) {
+      nodes[next_state].in_degree--;
+    }
+    nodes[s] = node{};
+    free_states.push_back(s);
+  }
+
+  acyclic_DFA_builder::state_type
+  acyclic_DFA_builder::clone_state(state_type s) {
+    auto const c = new_state();
+    nodes[c].is_final = nodes[s].is_final;
+    nodes[c].edges = nodes[s].edges;
+    for (auto const &[_, next_state] : nodes[c].edges) {
+      nodes[next_state].in_degree++;
+    }
+    return c;
+  }
+
+  void acyclic_DFA_builder::set_edge(state_type s, symbol_type a,
+                                     state_type next_state) {
+    nodes[next_state].in_degree++;
+    auto &edges = nodes[s].edges;
+    auto it = std::ranges::lower_bound(edges, a, {},
+                                       &std::pair<symbol_type, state_type>::first);
+    if (it != edges.end() && it->first == a) {
+      nodes[it->second].in_degree--;
+      it->second = next_state;
+      return;
+    }
+    edges.emplace(it, a, next_state);
+  }
+
+  void acyclic_DFA_builder::erase_edge(state_type s, symbol_type a) {
+    auto &edges = nodes[s].edges;
+    auto it = std::ranges::lower_bound(edges, a, {},
+                                       &std::pair<symbol_type, state_type>::first);
+    if (it != edges.end() && it->first == a) {
+      nodes[it->second].in_degree--;
+      edges.erase(it);
+    }
+  }
+
+  void acyclic_DFA_builder::unregister_state(state_type s) {
+    auto it = registry.find(get_signature(s));
+    if (it != registry.end() && it->second == s) {
+      registry.erase(it);
+    }
+  }
+
+  std::vector<acyclic_DFA_builder::state_type>
+  acyclic_DFA_builder::get_exclusive_path(symbol_string_view str) {
+    std::vector<state_type> path{root};
+    for (auto const a : str) {
+      auto next_state = go(path.back(), a);
+      if (!next_state.has_value()) {
+        break;
+      }
+      path.push_back(*next_state);
+    }
+    bool cloning = false;
+    for (size_t j = 1; j < path.size(); j++) {
+      if (!cloning && nodes[path[j]].in_degree > 1) {
+        cloning = true;
+      }
+      if (cloning) {
+        auto const c = clone_state(path[j]);
+        set_edge(path[j - 1], str[j - 1], c);
+        path[j] = c;
+      } else {
+        unregister_state(path[j]);
+      }
+    }
+    return path;
+  }
+
+  void acyclic_DFA_builder::replace_or_register(
+      const std::vector<state_type> &path, symbol_string_view str,
+      size_t prefix_length) {
+    for (auto j = path.size() - 1; j > prefix_length; j--) {
+      auto const s = path[j];
+      auto [it, has_emplaced] = registry.try_emplace(get_signature(s), s);
+      if (!has_emplaced && it->second != s) {
+        set_edge(path[j - 1], str[j - 1], it->second);
+        delete_state(s);
+      }
+    }
+  }
+
+  bool acyclic_DFA_builder::add(symbol_string_view str) {
+    check_symbols(str);
+    if (contains(str)) {
+      return false;
+    }
+    auto path = get_exclusive_path(str);
+    for (auto k = path.size() - 1; k < str.size(); k++) {
+      auto const s = new_state();
+      set_edge(path.back(), str[k], s);
+      path.push_back(s);
+    }
+    nodes[path.back()].is_final = true;
+    replace_or_register(path, str);
+    string_number++;
+    return true;
+  }
+
+  bool acyclic_DFA_builder::remove(symbol_string_view str) {
+    if (!contains(str)) {
+      return false;
+    }
+    auto path = get_exclusive_path(str);
+    nodes[path.back()].is_final = false;
+    // states left without strings are dropped
+    while (path.size() > 1) {
+      auto const s = path.back();
+      if (nodes[s].is_final || !nodes[s].edges.empty()) {
+        break;
+      }
+      erase_edge(path[path.size() - 2], str[path.size() - 2]);
+      delete_state(s);
+      path.pop_back();
+    }
+    replace_or_register(path, str);
+    string_number--;
+    return true;
+  }
+
+  bool acyclic_DFA_builder::contains(symbol_string_view str) const {
+    state_type s = root;
+    for (auto const a : str) {
+      auto next_state = go(s, a);
+      if (!next_state.has_value()) {
+        return false;
+      }
+      s = *next_state;
+    }
+    return nodes[s].is_final;
+  }
+
+  void acyclic_DFA_builder::add_sorted(symbol_string_view str) {
+    check_symbols(str);
+    if (string_number != 0 && str <= symbol_string_view(sorted_string)) {
+      throw exception::unsorted_strings("strings are not strictly increasing");
+    }
+    auto const common_prefix_length = static_cast<size_t>(
+        std::ranges::mismatch(sorted_string, str).in1 - sorted_string.begin());
+    // the previous string diverges here, so its suffix states are final
+    replace_or_register(sorted_path, sorted_string, common_prefix_length);
+    sorted_path.resize(common_prefix_length + 1);
+    for (auto k = common_prefix_length; k < str.size(); k++) {
+      auto const s = new_state();
+      set_edge(sorted_path.back(), str[k], s);
+      sorted_path.push_back(s);
+    }
+    nodes[sorted_path.back()].is_final = true;
+    sorted_string = str;
+    string_number++;
+  }
+
+  void acyclic_DFA_builder::finish_sorted() {
+    replace_or_register(sorted_path, sorted_string);
+    sorted_path = {root};
+    sorted_string.clear();
+  }
+
+  DFA acyclic_DFA_builder::to_DFA() const {
+    DFA::state_set_type states{0};
+    DFA::state_set_type final_states;
+    DFA::transition_function_type transition_function;
+    if (string_number == 0) {
+      for (auto const a : alphabet->get_view()) {
+        transition_function[{0, a}] = 0;
+      }
+      return {std::move(states), alphabet, 0, std::move(transition_function),
+              std::move(final_states)};
+    }
+
+    std::vector<DFA::state_type> state_numbers(nodes.size(), 0);
+    std::vector<state_type> queue{root};
+    bool has_dead_state = false;
+    for (size_t i = 0; i < queue.size(); i++) {
+      auto const s = queue[i];
+      for (auto const &[_, next_state] : nodes[s].edges) {
+        if (next_state != root && state_numbers[next_state] == 0) {
+          state_numbers[next_state] = queue.size();
+          queue.push_back(next_state);
+        }
+      }
+    }
+    auto const dead_state = static_cast<DFA::state_type>(queue.size());
+    for (size_t i = 0; i < queue.size(); i++) {
+      auto const s = queue[i];
+      states.insert(states.end(), i);
+      if (nodes[s].is_final) {
+        final_states.insert(final_states.end(), i);
+      }
+      for (auto const a : alphabet->get_view()) {
+        auto next_state = go(s, a);
+        if (next_state.has_value()) {
+          transition_function[{i, a}] = state_numbers[*next_state];
+        } else {
+          transition_function[{i, a}] = dead_state;
+          has_dead_state = true;
+        }
+      }
+    }
+    if (has_dead_state) {
+      states.insert(states.end(), dead_state);
+      for (auto const a : alphabet->get_view()) {
+        transition_function[{dead_state, a}] = dead_state;
+      }
+    }
+    return {std::move(states), alphabet, 0, std::move(transition_function),
+            std::move(final_states)};
+  }
+} // namespace cyy::computation
@@ -0,0 +1,96 @@
+/*!
+ * \file acyclic_dfa_builder.hpp
+ *
+ * \brief incremental construction of minimal acyclic DFAs
+ */
+
+#pragma once
+
+#include <ranges>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "dfa.hpp"
+
+namespace cyy::computation {
+  //! Keeps a minimal acyclic DFA of a finite string set under insertions and
+  //! deletions (Daciuk et al. 2000, Carrasco and Forcada 2002). An update
+  //! costs O(|string|) register operations.
+  class acyclic_DFA_builder {
+  public:
+    explicit acyclic_DFA_builder(ALPHABET_ptr alphabet_);
+
+    //! Build from strictly increasing strings, states are registered once
+    //! the following string diverges from them
+    template <std::ranges::input_range R>
+    static acyclic_DFA_builder from_sorted(ALPHABET_ptr alphabet_,
+                                           R &&strings) {
+      acyclic_DFA_builder builder(std::move(alphabet_));
+      for (auto const &str : strings) {
+        builder.add_sorted(str);
+      }
+      builder.finish_sorted();
+      return builder;
+    }
+
+    //! Return false if the string was present
+    bool add(symbol_string_view str);
+    //! Return false if the string was absent
+    bool remove(symbol_string_view str);
+    bool contains(symbol_string_view str) const;
+
+    size_t get_state_number() const noexcept {
+      return nodes.size() - free_states.size();
+    }
+    size_t get_string_number() const noexcept { return string_number; }
+
+    //! Minimal complete DFA, a dead state is added if needed
+    DFA to_DFA() const;
+
+  private:
+    using state_type = uint32_t;
+    struct node {
+      bool is_final{false};
+      //! sorted by symbol
+      std::vector<std::pair<symbol_type, state_type>> edges;
+      size_t in_degree{0};
+    };
+    using signature_type =
+        std::pair<bool, std::vector<std::pair<symbol_type, state_type>>>;
+    signature_type get_signature(state_type s) const {
+      return {nodes[s].is_final, nodes[s].edges};
+    }
+
+    void check_symbols(symbol_string_view str) const;
+    std::optional<state_type> go(state_type s, symbol_type a) const noexcept;
+    state_type new_state();
+    void delete_state(state_type s);
+    state_type clone_state(state_type s);
+    void set_edge(state_type s, symbol_type a, state_type next_state);
+    void erase_edge(state_type s, symbol_type a);
+    void unregister_state(state_type s);
+    //! Follow str from the root, cloning states from the first confluence
+    //! state so that the path is used only by str. The path contains the
+    //! root and has |prefix| + 1 states.
+    std::vector<state_type> get_exclusive_path(symbol_string_view str);
+    //! Merge path states with registered equivalent states from the end
+    void replace_or_register(const std::vector<state_type> &path,
+                             symbol_string_view str, size_t prefix_length = 0);
+    void add_sorted(symbol_string_view str);
+    void finish_sorted();
+
+    ALPHABET_ptr alphabet;
+    std::vector<node> nodes;
+    std::vector<state_type> free_states;
+    std::unordered_map<signature_type, state_type,
+                       boost::hash<signature_type>>
+        registry;
+    size_t string_number{0};
+    static constexpr state_type root = 0;
+    //! states of the last string in sorted construction
+    std::vector<state_type> sorted_path;
+    symbol_string sorted_string;
+  };
+} // namespace cyy::computation
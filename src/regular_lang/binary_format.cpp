@@ -0,0 +1,346 @@
+/*!
+ * \file binary_format.cpp
+ *
+ * \brief versioned binary format of finite automata
+ */
+
+#include "binary_format.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#include <boost/interprocess/file_mapping.hpp>
+
+#include "exception.hpp"
+
+namespace cyy::computation {
+  namespace {
+    static_assert(sizeof(symbol_type) <= sizeof(uint32_t));
+    using format = automaton_binary_format;
+
+    class binary_writer {
+    public:
+      explicit binary_writer(const std::filesystem::path &path)
+          : os(path, std::ios::binary | std::ios::trunc) {
+        if (!os) {
+          throw exception::invalid_automaton_binary("can't open " +
+                                                    path.string());
+        }
+      }
+
+      void write_uint32(uint64_t value) {
+        if (value > std::numeric_limits<uint32_t>::max()) {
+          throw exception::invalid_automaton_binary(
+              "value exceeds the range of the binary format");
+        }
+        auto v = static_cast<uint32_t>(value);
+        if constexpr (std::endian::native == std::endian::big) {
+          v = std::byteswap(v);
+        }
+        os.write(reinterpret_cast<const char *>(&v), sizeof(v));
+      }
+      void write_bytes(std::string_view bytes) {
+        os.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        auto const padding = format::padded_size(bytes.size()) - bytes.size();
+        for (size_t i = 0; i < padding; i++) {
+          os.put(0);
+        }
+      }
+
+    private:
+      std::ofstream os;
+    };
+
+    // return the symbol index map for the automaton
+    std::unordered_map<symbol_type, size_t>
+    write_header(binary_writer &writer, format::kind kind,
+                 const finite_automaton &automaton, size_t edge_number) {
+      auto const &alphabet = automaton.get_alphabet();
+      auto symbols = std::ranges::to<std::vector<symbol_type>>(
+          alphabet.get_view());
+      std::ranges::sort(symbols);
+
+      writer.write_bytes({format::magic.data(), format::magic.size()});
+      writer.write_uint32(format::version);
+      writer.write_uint32(std::to_underlying(kind));
+      writer.write_uint32(symbols.size());
+      writer.write_uint32(alphabet.get_name().size());
+      writer.write_uint32(automaton.get_states().size());
+      writer.write_uint32(
+          automaton.get_state_index(automaton.get_start_state()));
+      writer.write_uint32(edge_number);
+      writer.write_bytes(alphabet.get_name());
+
+      std::unordered_map<symbol_type, size_t> symbol_indices;
+      for (auto const &[index, symbol] : symbols | std::views::enumerate) {
+        writer.write_uint32(symbol);
+        symbol_indices.emplace(symbol, static_cast<size_t>(index));
+      }
+      std::string final_flags(automaton.get_states().size(), 0);
+      for (auto const s : automaton.get_final_states()) {
+        final_flags[automaton.get_state_index(s)] = 1;
+      }
+      writer.write_bytes(final_flags);
+      return symbol_indices;
+    }
+
+    struct automaton_sections {
+      std::string_view alphabet_name;
+      size_t symbol_number{};
+      size_t state_number{};
+      size_t edge_number{};
+      finite_automaton::state_type start_state{};
+      std::span<const std::byte> symbols;
+      std::span<const std::byte> final_flags;
+      std::span<const std::byte> body;
+    };
+
+    automaton_sections parse_sections(std::span<const std::byte> data,
+                                      format::kind expected_kind) {
+      if (data.size() < format::header_size ||
+          std::memcmp(data.data(), format::magic.data(),
+                      format::magic.size()) != 0) {
+        throw exception::invalid_automaton_binary("no automaton binary");
+      }
+      if (format::read_uint32(data, 1) != format::version) {
+        throw exception::invalid_automaton_binary("unsupported version");
+      }
+      if (format::read_uint32(data, 2) != std::to_underlying(expected_kind)) {
+        throw exception::invalid_automaton_binary("unexpected automaton kind");
+      }
+      automaton_sections sections;
+      sections.symbol_number = format::read_uint32(data, 3);
+      const size_t name_size = format::read_uint32(data, 4);
+      sections.state_number = format::read_uint32(data, 5);
+      sections.start_state = format::read_uint32(data, 6);
+      sections.edge_number = format::read_uint32(data, 7);
+      if (sections.start_state >= sections.state_number) {
+        throw exception::invalid_automaton_binary("no such start state");
+      }
+
+      auto remain = data.subspan(format::header_size);
+      auto take = [&remain](size_t size) {
+        if (remain.size() < size) {
+          throw exception::invalid_automaton_binary("truncated binary");
+        }
+        auto section = remain.first(size);
+        remain = remain.subspan(
+            std::min(format::padded_size(size), remain.size()));
+        return section;
+      };
+      auto name = take(name_size);
+      sections.alphabet_name = {reinterpret_cast<const char *>(name.data()),
+                                name.size()};
+      sections.symbols = take(sections.symbol_number * sizeof(uint32_t));
+      sections.final_flags = take(sections.state_number);
+      sections.body = remain;
+      return sections;
+    }
+
+    boost::interprocess::mapped_region
+    map_file(const std::filesystem::path &path) {
+      if (std::filesystem::file_size(path) < format::header_size) {
+        throw exception::invalid_automaton_binary("no automaton binary");
+      }
+      boost::interprocess::file_mapping const file(
+          path.string().c_str(), boost::interprocess::read_only);
+      return boost::interprocess::mapped_region(file,
+                                                boost::interprocess::read_only);
+    }
+
+    std::span<const std::byte>
+    get_data(const boost::interprocess::mapped_region &region) {
+      return {static_cast<const std::byte *>(region.get_address()),
+              region.get_size()};
+    }
+
+    ALPHABET_ptr get_alphabet(const automaton_sections &sections) {
+      auto alphabet = ALPHABET::get(std::string(sections.alphabet_name));
+      auto symbols = std::ranges::to<std::vector<symbol_type>>(
+          alphabet->get_view());
+      std::ranges::sort(symbols);
+      bool matched = symbols.size() == sections.symbol_number;
+      for (size_t i = 0; matched && i < symbols.size(); i++) {
+        matched = format::read_uint32(sections.symbols, i) ==
+                  static_cast<uint32_t>(symbols[i]);
+      }
+      if (!matched) {
+        throw exception::unmatched_alphabets(alphabet->get_name() +
+                                             " has different symbols");
+      }
+      return alphabet;
+    }
+
+    std::pair<finite_automaton::state_set_type,
+              finite_automaton::state_set_type>
+    get_states(const automaton_sections &sections) {
+      finite_automaton::state_set_type states;
+      finite_automaton::state_set_type final_states;
+      for (size_t i = 0; i < sections.state_number; i++) {
+        states.insert(states.end(), i);
+        if (sections.final_flags[i] != std::byte{0}) {
+          final_states.insert(final_states.end(), i);
+        }
+      }
+      return {std::move(states), std::move(final_states)};
+    }
+  } // namespace
+
+  void save_binary(const DFA &dfa, const std::filesystem::path &path) {
+    binary_writer writer(path);
+    auto symbol_indices =
+        write_header(writer, format::kind::DFA, dfa, 0);
+    std::vector<size_t> table(dfa.get_states().size() * symbol_indices.size());
+    for (auto const &[situation, next_state] : dfa.get_transition_function()) {
+      table[dfa.get_state_index(situation.state) * symbol_indices.size() +
+            symbol_indices[situation.input_symbol]] =
+          dfa.get_state_index(next_state);
+    }
+    for (auto const next_state : table) {
+      writer.write_uint32(next_state);
+    }
+  }
+
+  void save_binary(const NFA &nfa, const std::filesystem::path &path) {
+    size_t edge_number = 0;
+    for (auto const &[_, next_states] : nfa.get_transition_function()) {
+      edge_number += next_states.size();
+    }
+    binary_writer writer(path);
+    auto symbol_indices =
+        write_header(writer, format::kind::NFA, nfa, edge_number);
+    for (auto const &[situation, next_states] :
+         nfa.get_transition_function()) {
+      for (auto const next_state : next_states) {
+        writer.write_uint32(nfa.get_state_index(situation.state));
+        writer.write_uint32(symbol_indices[situation.input_symbol]);
+        writer.write_uint32(nfa.get_state_index(next_state));
+      }
+    }
+    size_t epsilon_edge_number = 0;
+    for (auto const &[_, next_states] : nfa.get_epsilon_transition_function()) {
+      epsilon_edge_number += next_states.size();
+    }
+    writer.write_uint32(epsilon_edge_number);
+    for (auto const &[s, next_states] :
+         nfa.get_epsilon_transition_function()) {
+      for (auto const next_state : next_states) {
+        writer.write_uint32(nfa.get_state_index(s));
+        writer.write_uint32(nfa.get_state_index(next_state));
+      }
+    }
+  }
+
+  NFA load_NFA_binary(const std::filesystem::path &path) {
+    auto region = map_file(path);
+    auto sections = parse_sections(get_data(region), format::kind::NFA);
+    auto alphabet = get_alphabet(sections);
+    auto [states, final_states] = get_states(sections);
+    auto const &body = sections.body;
+    auto const body_size = body.size() / sizeof(uint32_t);
+    if (body_size < sections.edge_number * 3 + 1) {
+      throw exception::invalid_automaton_binary("truncated binary");
+    }
+    auto read_state = [&](size_t index) -> NFA::state_type {
+      auto s = format::read_uint32(body, index);
+      if (s >= sections.state_number) {
+        throw exception::invalid_automaton_binary("no such state");
+      }
+      return s;
+    };
+
+    NFA::transition_function_type transition_function;
+    for (size_t i = 0; i < sections.edge_number; i++) {
+      auto s = read_state(i * 3);
+      auto symbol_index = format::read_uint32(body, i * 3 + 1);
+      if (symbol_index >= sections.symbol_number) {
+        throw exception::invalid_automaton_binary("no such symbol");
+      }
+      transition_function[{s, static_cast<symbol_type>(format::read_uint32(
+                                  sections.symbols, symbol_index))}]
+          .insert(read_state(i * 3 + 2));
+    }
+    auto const epsilon_offset = sections.edge_number * 3;
+    const size_t epsilon_edge_number =
+        format::read_uint32(body, epsilon_offset);
+    if (body_size < epsilon_offset + 1 + epsilon_edge_number * 2) {
+      throw exception::invalid_automaton_binary("truncated binary");
+    }
+    NFA::epsilon_transition_function_type epsilon_transition_function;
+    for (size_t i = 0; i < epsilon_edge_number; i++) {
+      epsilon_transition_function[read_state(epsilon_offset + 1 + i * 2)]
+          .insert(read_state(epsilon_offset + 2 + i * 2));
+    }
+    return {std::move(states),
+            std::move(alphabet),
+            sections.start_state,
+            std::move(transition_function),
+            std::move(final_states),
+            std::move(epsilon_transition_function)};
+  }
+
+  mapped_DFA::mapped_DFA(const std::filesystem::path &path)
+      : region(map_file(path)) {
+    auto sections = parse_sections(get_data(region), format::kind::DFA);
+    alphabet_name = sections.alphabet_name;
+    state_number = sections.state_number;
+    symbol_number = sections.symbol_number;
+    start_state = sections.start_state;
+    symbols = sections.symbols;
+    final_flags = sections.final_flags;
+    const auto table_size = state_number * symbol_number * sizeof(uint32_t);
+    if (sections.body.size() < table_size) {
+      throw exception::invalid_automaton_binary("truncated binary");
+    }
+    transition_table = sections.body.first(table_size);
+  }
+
+  std::optional<size_t>
+  mapped_DFA::get_symbol_index(symbol_type a) const noexcept {
+    // symbols are sorted
+    size_t low = 0;
+    size_t high = symbol_number;
+    while (low < high) {
+      auto mid = low + (high - low) / 2;
+      if (automaton_binary_format::read_uint32(symbols, mid) <
+          static_cast<uint32_t>(a)) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    if (low < symbol_number && automaton_binary_format::read_uint32(
+                                   symbols, low) == static_cast<uint32_t>(a)) {
+      return low;
+    }
+    return {};
+  }
+
+  DFA mapped_DFA::to_DFA() const {
+    automaton_sections sections;
+    sections.alphabet_name = alphabet_name;
+    sections.symbol_number = symbol_number;
+    sections.state_number = state_number;
+    sections.symbols = symbols;
+    sections.final_flags = final_flags;
+    auto alphabet = get_alphabet(sections);
+    auto [states, final_states] = get_states(sections);
+    DFA::transition_function_type transition_function;
+    for (state_type s = 0; s < state_number; s++) {
+      for (size_t i = 0; i < symbol_number; i++) {
+        auto next_state = automaton_binary_format::read_uint32(
+            transition_table, s * symbol_number + i);
+        if (next_state >= state_number) {
+          throw exception::invalid_automaton_binary("no such state");
+        }
+        transition_function[{s, static_cast<symbol_type>(
+                                    automaton_binary_format::read_uint32(
+                                        symbols, i))}] = next_state;
+      }
+    }
+    return {std::move(states), std::move(alphabet), start_state,
+            std::move(transition_function), std::move(final_states)};
+  }
+} // namespace cyy::computation
@@ -0,0 +1,125 @@
+/*!
+ * \file binary_format.hpp
+ *
+ * \brief versioned binary format of finite automata
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "dfa.hpp"
+#include "nfa.hpp"
+
+namespace cyy::computation {
+  /*
+     All integers are little-endian uint32, sections are padded to 4 bytes.
+
+     header: magic "CYFA", version, kind, symbol count, alphabet name size,
+             state count, start state, edge count (NFA only)
+     alphabet: name bytes, symbols in ascending order
+     final flags: one byte per state
+     DFA: next state table indexed by state * symbol count + symbol index
+     NFA: edges (state, symbol index, next state) followed by
+          epsilon edge count and epsilon edges (state, next state)
+
+     States are stored by their index in the state set, so a loaded automaton
+     has states 0 ... n-1. The alphabet is resolved by name with
+     ALPHABET::get and checked against the stored symbols.
+  */
+  class automaton_binary_format {
+  public:
+    static constexpr std::array<char, 4> magic{'C', 'Y', 'F', 'A'};
+    static constexpr uint32_t version = 1;
+    enum class kind : uint32_t { DFA = 1, NFA = 2 };
+    static constexpr size_t header_size = 8 * sizeof(uint32_t);
+
+    template <std::unsigned_integral T>
+    static T read_integer(const std::byte *ptr) noexcept {
+      T value;
+      std::memcpy(&value, ptr, sizeof(T));
+      if constexpr (std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+      }
+      return value;
+    }
+    static uint32_t read_uint32(std::span<const std::byte> data,
+                                size_t index) noexcept {
+      return read_integer<uint32_t>(data.data() + index * sizeof(uint32_t));
+    }
+    static constexpr size_t padded_size(size_t size) noexcept {
+      return (size + sizeof(uint32_t) - 1) / sizeof(uint32_t) *
+             sizeof(uint32_t);
+    }
+  };
+
+  void save_binary(const DFA &dfa, const std::filesystem::path &path);
+  void save_binary(const NFA &nfa, const std::filesystem::path &path);
+  NFA load_NFA_binary(const std::filesystem::path &path);
+
+  //! A read-only DFA backed by a memory-mapped file, the transition table is
+  //! used in place.
+  class mapped_DFA {
+  public:
+    using state_type = finite_automaton::state_type;
+    explicit mapped_DFA(const std::filesystem::path &path);
+
+    mapped_DFA(const mapped_DFA &) = delete;
+    mapped_DFA &operator=(const mapped_DFA &) = delete;
+    mapped_DFA(mapped_DFA &&) noexcept = default;
+    mapped_DFA &operator=(mapped_DFA &&) noexcept = default;
+    ~mapped_DFA() = default;
+
+    std::string_view get_alphabet_name() const noexcept {
+      return alphabet_name;
+    }
+    size_t get_state_number() const noexcept { return state_number; }
+    state_type get_start_state() const noexcept { return start_state; }
+    bool is_final_state(state_type s) const noexcept {
+      return final_flags[s] != std::byte{0};
+    }
+
+    std::optional<state_type> go(state_type s, symbol_type a) const noexcept {
+      auto symbol_index = get_symbol_index(a);
+      if (!symbol_index.has_value() || s >= state_number) {
+        return {};
+      }
+      return automaton_binary_format::read_uint32(
+          transition_table, s * symbol_number + *symbol_index);
+    }
+
+    bool recognize(symbol_string_view view) const noexcept {
+      state_type s = start_state;
+      for (auto const symbol : view) {
+        auto next_state = go(s, symbol);
+        if (!next_state.has_value()) {
+          return false;
+        }
+        s = *next_state;
+      }
+      return s < state_number && is_final_state(s);
+    }
+
+    //! Build an ordinary DFA from the mapped table
+    DFA to_DFA() const;
+
+  private:
+    std::optional<size_t> get_symbol_index(symbol_type a) const noexcept;
+
+    boost::interprocess::mapped_region region;
+    std::string_view alphabet_name;
+    size_t state_number{};
+    size_t symbol_number{};
+    state_type start_state{};
+    std::span<const std::byte> symbols;
+    std::span<const std::byte> final_flags;
+    std::span<const std::byte> transition_table;
+  };
+} // namespace cyy::computation
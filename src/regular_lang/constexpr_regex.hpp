@@ -0,0 +1,444 @@
+/*!
+ * \file constexpr_regex.hpp
+ *
+ * \brief compile regex literals to DFAs at compile time
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "dfa.hpp"
+
+namespace cyy::computation {
+  template <size_t N> struct regex_string {
+    consteval regex_string(const char32_t (&str)[N]) {
+      std::ranges::copy(str, data.begin());
+    }
+    constexpr std::u32string_view view() const noexcept {
+      return {data.data(), N - 1};
+    }
+    std::array<char32_t, N> data{};
+  };
+
+  namespace constexpr_regex_detail {
+    struct symbol_range {
+      char32_t first;
+      char32_t last;
+    };
+
+    struct compiled_regex {
+      std::vector<char32_t> interval_begins;
+      std::vector<uint32_t> interval_classes;
+      size_t class_number{};
+      std::vector<uint32_t> transition_table;
+      std::vector<bool> final_states;
+    };
+
+    /*
+       McNaughton-Yamada construction as in regex::to_DFA. Symbols are
+       split into classes of equivalent intervals since no alphabet is
+       available at compile time, so '.' and [^...] complement against all
+       symbols. ASCII escape sequences are always supported.
+    */
+    class regex_compiler {
+    public:
+      constexpr explicit regex_compiler(std::u32string_view pattern_)
+          : pattern(pattern_) {}
+
+      constexpr compiled_regex compile() {
+        auto root = parse_expr();
+        if (pos != pattern.size()) {
+          throw std::invalid_argument("unmatched )");
+        }
+        // a virtual start position is followed by the first positions
+        auto const start_position = position_ranges.size();
+        follow.push_back(root.first);
+        position_ranges.emplace_back();
+
+        auto [interval_begins, interval_classes, class_number, matches] =
+            make_symbol_classes();
+
+        auto is_final = [&](const std::vector<size_t> &state) {
+          return std::ranges::any_of(state, [&](auto p) {
+            return (p == start_position && root.nullable) ||
+                   std::ranges::find(root.last, p) != root.last.end();
+          });
+        };
+
+        std::vector<std::vector<size_t>> states{{start_position}};
+        compiled_regex result;
+        for (size_t i = 0; i < states.size(); i++) {
+          result.final_states.push_back(is_final(states[i]));
+          for (size_t c = 0; c < class_number; c++) {
+            std::vector<size_t> next_state;
+            for (auto p : states[i]) {
+              for (auto q : follow[p]) {
+                if (matches[(q * class_number) + c]) {
+                  next_state.push_back(q);
+                }
+              }
+            }
+            std::ranges::sort(next_state);
+            auto [first, last] = std::ranges::unique(next_state);
+            next_state.erase(first, last);
+            auto it = std::ranges::find(states, next_state);
+            if (it == states.end()) {
+              states.push_back(std::move(next_state));
+              it = states.end() - 1;
+            }
+            result.transition_table.push_back(
+                static_cast<uint32_t>(it - states.begin()));
+          }
+        }
+        result.interval_begins = std::move(interval_begins);
+        result.interval_classes = std::move(interval_classes);
+        result.class_number = class_number;
+        return result;
+      }
+
+    private:
+      struct fragment {
+        bool nullable{true};
+        std::vector<size_t> first;
+        std::vector<size_t> last;
+      };
+
+      constexpr bool at_end() const noexcept { return pos >= pattern.size(); }
+      constexpr char32_t peek() const noexcept { return pattern[pos]; }
+      constexpr char32_t next() {
+        if (at_end()) {
+          throw std::invalid_argument("unexpected end of regex");
+        }
+        return pattern[pos++];
+      }
+      static constexpr bool is_operator(char32_t c) noexcept {
+        return std::u32string_view(U"|*()\\+?[].^-").contains(c);
+      }
+      static constexpr char32_t escape_symbol(char32_t c) noexcept {
+        switch (c) {
+          case 'f':
+            return '\f';
+          case 'n':
+            return '\n';
+          case 'r':
+            return '\r';
+          case 't':
+            return '\t';
+          case 'v':
+            return '\v';
+          default:
+            return c;
+        }
+      }
+
+      constexpr fragment make_position(std::vector<symbol_range> ranges) {
+        auto const p = position_ranges.size();
+        position_ranges.push_back(std::move(ranges));
+        follow.emplace_back();
+        return {.nullable = false, .first = {p}, .last = {p}};
+      }
+      constexpr void add_follow(const std::vector<size_t> &from,
+                                const std::vector<size_t> &to) {
+        for (auto p : from) {
+          follow[p].insert(follow[p].end(), to.begin(), to.end());
+        }
+      }
+
+      constexpr fragment parse_expr() {
+        // as in the runtime grammar, an expression may be empty but an
+        // alternative may not
+        if (at_end() || peek() == ')') {
+          return {};
+        }
+        auto result = parse_term();
+        while (!at_end() && peek() == '|') {
+          pos++;
+          auto rhs = parse_term();
+          result.nullable = result.nullable || rhs.nullable;
+          result.first.insert(result.first.end(), rhs.first.begin(),
+                              rhs.first.end());
+          result.last.insert(result.last.end(), rhs.last.begin(),
+                             rhs.last.end());
+        }
+        return result;
+      }
+
+      constexpr fragment parse_term() {
+        // a term has at least one factor, as the rterm rule of regex
+        if (at_end() || peek() == '|' || peek() == ')') {
+          throw std::invalid_argument("empty alternative");
+        }
+        fragment result;
+        while (!at_end() && peek() != '|' && peek() != ')') {
+          auto rhs = parse_factor();
+          add_follow(result.last, rhs.first);
+          if (result.nullable) {
+            result.first.insert(result.first.end(), rhs.first.begin(),
+                                rhs.first.end());
+          }
+          if (rhs.nullable) {
+            rhs.last.insert(rhs.last.end(), result.last.begin(),
+                            result.last.end());
+          }
+          result.last = std::move(rhs.last);
+          result.nullable = result.nullable && rhs.nullable;
+        }
+        return result;
+      }
+
+      constexpr fragment parse_factor() {
+        auto result = parse_primary();
+        if (at_end()) {
+          return result;
+        }
+        switch (peek()) {
+          case '*':
+            add_follow(result.last, result.first);
+            result.nullable = true;
+            break;
+          case '+':
+            add_follow(result.last, result.first);
+            break;
+          case '?':
+            result.nullable = true;
+            break;
+          default:
+            return result;
+        }
+        pos++;
+        return result;
+      }
+
+      constexpr fragment parse_primary() {
+        auto const c = next();
+        switch (c) {
+          case '(': {
+            auto result = parse_expr();
+            if (next() != ')') {
+              throw std::invalid_argument("missing )");
+            }
+            return result;
+          }
+          case '[':
+            return make_position(parse_character_class());
+          case '.':
+            return make_position(complement({{'\n', '\n'}, {'\r', '\r'}}));
+          case '\\': {
+            auto const symbol = escape_symbol(next());
+            return make_position({{symbol, symbol}});
+          }
+          default:
+            if (is_operator(c)) {
+              throw std::invalid_argument("unexpected operator");
+            }
+            return make_position({{c, c}});
+        }
+      }
+
+      constexpr std::vector<symbol_range> parse_character_class() {
+        bool complemented = false;
+        if (!at_end() && peek() == '^') {
+          complemented = true;
+          pos++;
+        }
+        std::vector<symbol_range> ranges;
+        while (next() != ']') {
+          pos--;
+          if (peek() == '-') {
+            pos++;
+            if (ranges.empty() || ranges.back().first != ranges.back().last) {
+              throw std::invalid_argument("invalid character range");
+            }
+            auto const last = parse_class_element();
+            if (last < ranges.back().first) {
+              throw std::invalid_argument("invalid character range");
+            }
+            ranges.back().last = last;
+            continue;
+          }
+          auto const c = parse_class_element();
+          ranges.push_back({c, c});
+        }
+        if (ranges.empty()) {
+          throw std::invalid_argument("empty character class");
+        }
+        if (complemented) {
+          return complement(std::move(ranges));
+        }
+        return ranges;
+      }
+
+      constexpr char32_t parse_class_element() {
+        auto const c = next();
+        if (c == '\\') {
+          return escape_symbol(next());
+        }
+        if (c == ']' || c == '-' || c == '^') {
+          throw std::invalid_argument("invalid character class element");
+        }
+        return c;
+      }
+
+      static constexpr std::vector<symbol_range>
+      complement(std::vector<symbol_range> ranges) {
+        std::ranges::sort(ranges, {}, &symbol_range::first);
+        std::vector<symbol_range> result;
+        char32_t begin = 0;
+        bool reach_end = false;
+        for (auto const &range : ranges) {
+          if (range.first > begin) {
+            result.push_back({begin, static_cast<char32_t>(range.first - 1)});
+          }
+          if (range.last == std::numeric_limits<char32_t>::max()) {
+            reach_end = true;
+            break;
+          }
+          begin = std::max(begin, static_cast<char32_t>(range.last + 1));
+        }
+        if (!reach_end) {
+          result.push_back({begin, std::numeric_limits<char32_t>::max()});
+        }
+        return result;
+      }
+
+      struct symbol_classes {
+        std::vector<char32_t> interval_begins;
+        std::vector<uint32_t> interval_classes;
+        size_t class_number{};
+        // matches[position * class_number + class]
+        std::vector<bool> matches;
+      };
+
+      // split symbols into intervals and merge intervals matched by the same
+      // positions into classes
+      constexpr symbol_classes make_symbol_classes() const {
+        symbol_classes result;
+        auto &interval_begins = result.interval_begins;
+        interval_begins.push_back(0);
+        for (auto const &ranges : position_ranges) {
+          for (auto const &range : ranges) {
+            interval_begins.push_back(range.first);
+            if (range.last != std::numeric_limits<char32_t>::max()) {
+              interval_begins.push_back(range.last + 1);
+            }
+          }
+        }
+        std::ranges::sort(interval_begins);
+        auto [first, last] = std::ranges::unique(interval_begins);
+        interval_begins.erase(first, last);
+
+        std::vector<std::vector<bool>> class_signatures;
+        for (auto const begin : interval_begins) {
+          std::vector<bool> signature;
+          for (auto const &ranges : position_ranges) {
+            signature.push_back(std::ranges::any_of(ranges, [&](auto r) {
+              return r.first <= begin && begin <= r.last;
+            }));
+          }
+          auto it = std::ranges::find(class_signatures, signature);
+          if (it == class_signatures.end()) {
+            class_signatures.push_back(std::move(signature));
+            it = class_signatures.end() - 1;
+          }
+          result.interval_classes.push_back(
+              static_cast<uint32_t>(it - class_signatures.begin()));
+        }
+        result.class_number = class_signatures.size();
+        result.matches.resize(position_ranges.size() * result.class_number);
+        for (size_t c = 0; c < class_signatures.size(); c++) {
+          for (size_t p = 0; p < position_ranges.size(); p++) {
+            result.matches[(p * result.class_number) + c] =
+                class_signatures[c][p];
+          }
+        }
+        return result;
+      }
+
+      std::u32string_view pattern;
+      size_t pos{};
+      std::vector<std::vector<symbol_range>> position_ranges;
+      std::vector<std::vector<size_t>> follow;
+    };
+
+    constexpr compiled_regex compile(std::u32string_view pattern) {
+      return regex_compiler(pattern).compile();
+    }
+  } // namespace constexpr_regex_detail
+
+  //! A DFA whose transition table has a size fixed at compile time
+  template <size_t state_number, size_t class_number, size_t interval_number>
+  class static_DFA {
+  public:
+    constexpr bool recognize(std::u32string_view view) const noexcept {
+      uint32_t s = 0;
+      for (auto const symbol : view) {
+        s = go(s, symbol);
+      }
+      return final_states[s];
+    }
+    constexpr uint32_t go(uint32_t s, char32_t symbol) const noexcept {
+      return transition_table[(s * class_number) + get_symbol_class(symbol)];
+    }
+    constexpr bool is_final_state(uint32_t s) const noexcept {
+      return final_states[s];
+    }
+    static constexpr size_t get_state_number() noexcept {
+      return state_number;
+    }
+
+    //! Convert to a runtime DFA over the alphabet
+    DFA to_DFA(ALPHABET_ptr alphabet) const {
+      DFA::state_set_type states;
+      DFA::state_set_type DFA_final_states;
+      DFA::transition_function_type transition_function;
+      for (uint32_t s = 0; s < state_number; s++) {
+        states.insert(states.end(), s);
+        if (final_states[s]) {
+          DFA_final_states.insert(DFA_final_states.end(), s);
+        }
+        for (auto a : alphabet->get_view()) {
+          transition_function[{s, a}] = go(s, a);
+        }
+      }
+      return {std::move(states), std::move(alphabet), 0,
+              std::move(transition_function), std::move(DFA_final_states)};
+    }
+
+    std::array<char32_t, interval_number> interval_begins{};
+    std::array<uint32_t, interval_number> interval_classes{};
+    std::array<uint32_t, state_number * class_number> transition_table{};
+    std::array<bool, state_number> final_states{};
+
+  private:
+    constexpr uint32_t get_symbol_class(char32_t symbol) const noexcept {
+      // interval_begins[0] is 0
+      auto it = std::ranges::upper_bound(interval_begins, symbol);
+      return interval_classes[static_cast<size_t>(
+          it - interval_begins.begin() - 1)];
+    }
+  };
+
+  //! Compile a regex literal, e.g. compile_regex<U"(a|b)*abb">()
+  template <regex_string pattern> consteval auto compile_regex() {
+    constexpr auto sizes = [] {
+      auto compiled = constexpr_regex_detail::compile(pattern.view());
+      return std::array<size_t, 3>{compiled.final_states.size(),
+                                   compiled.class_number,
+                                   compiled.interval_begins.size()};
+    }();
+    static_DFA<sizes[0], sizes[1], sizes[2]> dfa;
+    auto compiled = constexpr_regex_detail::compile(pattern.view());
+    std::ranges::copy(compiled.interval_begins, dfa.interval_begins.begin());
+    std::ranges::copy(compiled.interval_classes, dfa.interval_classes.begin());
+    std::ranges::copy(compiled.transition_table, dfa.transition_table.begin());
+    std::ranges::copy(compiled.final_states, dfa.final_states.begin());
+    return dfa;
+  }
+} // namespace cyy::computation
@@ -7,9 +7,50 @@
 
 #include "dfa.hpp"
 
+#include <numeric>
+
 #include "exception.hpp"
 
 namespace cyy::computation {
+  namespace {
+    class disjoint_set {
+    public:
+      explicit disjoint_set(size_t size) : parents(size), ranks(size, 0) {
+        std::ranges::iota(parents, size_t(0));
+      }
+      size_t find(size_t x) {
+        auto root = x;
+        while (parents[root] != root) {
+          root = parents[root];
+        }
+        while (parents[x] != root) {
+          x = std::exchange(parents[x], root);
+        }
+        return root;
+      }
+      // return false if x and y are already in the same set
+      bool unite(size_t x, size_t y) {
+        x = find(x);
+        y = find(y);
+        if (x == y) {
+          return false;
+        }
+        if (ranks[x] < ranks[y]) {
+          std::swap(x, y);
+        }
+        parents[y] = x;
+        if (ranks[x] == ranks[y]) {
+          ranks[x]++;
+        }
+        return true;
+      }
+
+    private:
+      std::vector<size_t> parents;
+      std::vector<uint8_t> ranks;
+    };
+  } // namespace
+
   bool DFA::equivalent_with(const DFA &rhs) const {
 
     if (alphabet != rhs.alphabet) {
@@ -68,25 +109,91 @@ namespace cyy::computation {
         final_states, [&rhs](auto s) { return rhs.final_states.contains(s); });
   }
 
+  std::optional<symbol_string>
+  DFA::get_distinguishing_string(const DFA &rhs) const {
+    if (*alphabet != *rhs.alphabet) {
+      throw exception::unmatched_alphabets(alphabet->get_name() + " and " +
+                                           rhs.alphabet->get_name());
+    }
+    const auto state_num = get_states().size();
+    disjoint_set state_sets(state_num + rhs.get_states().size());
+
+    struct state_pair {
+      state_type state;
+      state_type rhs_state;
+      size_t parent;
+      input_symbol_type symbol;
+    };
+    constexpr auto no_parent = std::numeric_limits<size_t>::max();
+    std::vector<state_pair> pairs{
+        {get_start_state(), rhs.get_start_state(), no_parent, {}}};
+    state_sets.unite(get_state_index(get_start_state()),
+                     state_num + rhs.get_state_index(rhs.get_start_state()));
+
+    // every merged pair is checked exactly once, so the loop runs in
+    // O((m+n)·|Σ|·α(m+n)) time.
+    for (size_t i = 0; i < pairs.size(); i++) {
+      // copy states since pairs may grow below
+      const auto s = pairs[i].state;
+      const auto rhs_s = pairs[i].rhs_state;
+      if (is_final_state(s) != rhs.is_final_state(rhs_s)) {
+        symbol_string str;
+        for (auto j = i; pairs[j].parent != no_parent; j = pairs[j].parent) {
+          str.push_back(pairs[j].symbol);
+        }
+        std::ranges::reverse(str);
+        return str;
+      }
+      for (auto a : alphabet->get_view()) {
+        auto next_state = go(s, a).value();
+        auto rhs_next_state = rhs.go(rhs_s, a).value();
+        if (state_sets.unite(get_state_index(next_state),
+                             state_num +
+                                 rhs.get_state_index(rhs_next_state))) {
+          pairs.emplace_back(next_state, rhs_next_state, i, a);
+        }
+      }
+    }
+    return {};
+  }
+
   std::pair<DFA, std::vector<DFA::state_set_type>>
   DFA::minimize(std::vector<state_set_type> init_partition) const {
     std::vector<state_set_type> groups = std::move(init_partition);
     if (groups.empty()) {
-      groups = {get_non_final_states(), final_states};
-    } else {
-#ifndef NDEBUG
-      for (auto &g : groups) {
-        for (auto state : g) {
-          assert(has_state(state));
+      // partition the trimmed DFA and map its groups back to these states
+      auto [trimmed_dfa, trimmed_states] = trim_with_mapping();
+      auto final_states_of_trimmed = trimmed_dfa.get_final_states();
+      auto non_final_states_of_trimmed = trimmed_dfa.get_non_final_states();
+      if (!non_final_states_of_trimmed.empty()) {
+        groups.emplace_back(std::move(non_final_states_of_trimmed));
+      }
+      if (!final_states_of_trimmed.empty()) {
+        groups.emplace_back(std::move(final_states_of_trimmed));
+      }
+      auto result = trimmed_dfa.minimize(std::move(groups));
+      for (auto &group : result.second) {
+        state_set_type states;
+        for (auto const s : group) {
+          states.merge(trimmed_states[s]);
         }
+        group = std::move(states);
+      }
+      return result;
+    }
+#ifndef NDEBUG
+    for (auto &g : groups) {
+      for (auto state : g) {
+        assert(has_state(state));
       }
-#endif
     }
+#endif
 
     std::unordered_map<state_type, size_t> state_to_group_index;
     bool has_new_group = true;
 
     while (has_new_group) {
+      instrumentation::add(instrumentation::counter::DFA_minimization_round);
       for (size_t i = 0; i < groups.size(); i++) {
         for (auto state : groups[i]) {
           state_to_group_index[state] = i;
@@ -156,27 +263,143 @@ namespace cyy::computation {
                 std::move(minimize_DFA_final_states)},
             std::move(groups)};
   }
-  void DFA::mark_live_states() const {
-    if (live_states_opt.has_value()) {
-      return;
+  DFA::state_bitset_type DFA::compute_live_state_bitset() const {
+    instrumentation::add(instrumentation::counter::DFA_live_state_computation);
+    // walk the reversed transition graph from final states
+    std::vector<std::vector<size_t>> reverse_edges(get_states().size());
+    for (auto const &[situation, next_state] : transition_function) {
+      reverse_edges[get_state_index(next_state)].push_back(
+          get_state_index(situation.state));
     }
-    std::unordered_map<state_type, state_set_type> state_dep;
-    for (auto const &[p, next_state] : transition_function) {
-      state_dep[next_state].insert(p.state);
+    auto live_states = get_bitset(final_states);
+    std::vector<size_t> queue;
+    queue.reserve(get_states().size());
+    for (auto i = live_states.find_first(); i != state_bitset_type::npos;
+         i = live_states.find_next(i)) {
+      queue.push_back(i);
     }
-    auto live_states = final_states;
-    while (true) {
-      const auto live_state_size = live_states.size();
-      state_set_type new_live_states;
-      for (auto s : live_states) {
-        new_live_states.merge(state_set_type(state_dep[s]));
+    for (size_t i = 0; i < queue.size(); i++) {
+      for (auto prev : reverse_edges[queue[i]]) {
+        if (!live_states.test_set(prev)) {
+          queue.push_back(prev);
+        }
       }
-      live_states.merge(std::move(new_live_states));
-      if (live_states.size() == live_state_size) {
-        break;
+    }
+    return live_states;
+  }
+
+  DFA::state_set_type DFA::get_live_states() const {
+    auto const &live_states = get_live_state_bitset();
+    state_set_type result;
+    for (auto const s : get_states()) {
+      if (live_states.test(get_state_index(s))) {
+        result.insert(result.end(), s);
+      }
+    }
+    return result;
+  }
+
+  DFA::state_bitset_type DFA::get_reachable_state_bitset() const {
+    auto reachable_states = get_bitset(0);
+    reachable_states.set(get_state_index(get_start_state()));
+    std::vector<state_type> queue{get_start_state()};
+    for (size_t i = 0; i < queue.size(); i++) {
+      for (auto a : alphabet->get_view()) {
+        auto next_state = go(queue[i], a).value();
+        if (!reachable_states.test_set(get_state_index(next_state))) {
+          queue.push_back(next_state);
+        }
+      }
+    }
+    return reachable_states;
+  }
+
+  DFA::state_bitset_type DFA::get_useful_state_bitset() const {
+    auto useful_states = get_reachable_state_bitset();
+    useful_states &= get_live_state_bitset();
+    return useful_states;
+  }
+
+  DFA DFA::trim() const { return trim_with_mapping().first; }
+
+  std::pair<DFA, std::vector<DFA::state_set_type>>
+  DFA::trim_with_mapping() const {
+    auto const useful_states = get_useful_state_bitset();
+    state_set_type new_states{0};
+    transition_function_type new_transition_function;
+    state_set_type new_final_states;
+    std::vector<state_set_type> original_states;
+    // the reject state stands for the reachable dead states, states reached
+    // from a dead state are dead too
+    state_set_type dead_states;
+    std::vector<state_type> dead_queue;
+    auto add_dead_state = [&](state_type s) {
+      if (dead_states.insert(s).second) {
+        dead_queue.push_back(s);
+      }
+    };
+    auto collect_dead_states = [&]() {
+      for (size_t i = 0; i < dead_queue.size(); i++) {
+        for (auto a : alphabet->get_view()) {
+          add_dead_state(go(dead_queue[i], a).value());
+        }
+      }
+      return std::move(dead_states);
+    };
+    if (!useful_states.test(get_state_index(get_start_state()))) {
+      for (auto a : alphabet->get_view()) {
+        new_transition_function[{0, a}] = 0;
+      }
+      add_dead_state(get_start_state());
+      original_states.emplace_back(collect_dead_states());
+      return {{std::move(new_states), alphabet, 0,
+               std::move(new_transition_function),
+               std::move(new_final_states)},
+              std::move(original_states)};
+    }
+
+    // renumber useful states in BFS order from the start state
+    std::unordered_map<state_type, state_type> state_map{
+        {get_start_state(), 0}};
+    std::vector<state_type> queue{get_start_state()};
+    std::vector<situation_type> reject_situations;
+    for (size_t i = 0; i < queue.size(); i++) {
+      auto const s = queue[i];
+      original_states.push_back({s});
+      if (is_final_state(s)) {
+        new_final_states.insert(i);
+      }
+      for (auto a : alphabet->get_view()) {
+        auto next_state = go(s, a).value();
+        if (!useful_states.test(get_state_index(next_state))) {
+          reject_situations.emplace_back(i, a);
+          add_dead_state(next_state);
+          continue;
+        }
+        auto [it, has_emplaced] =
+            state_map.try_emplace(next_state, queue.size());
+        if (has_emplaced) {
+          queue.push_back(next_state);
+          new_states.insert(it->second);
+        }
+        new_transition_function[{i, a}] = it->second;
+      }
+    }
+    if (!reject_situations.empty()) {
+      // the reject state gets the last number
+      const auto reject_state = static_cast<state_type>(queue.size());
+      new_states.insert(reject_state);
+      for (auto const &situation : reject_situations) {
+        new_transition_function[situation] = reject_state;
+      }
+      for (auto a : alphabet->get_view()) {
+        new_transition_function[{reject_state, a}] = reject_state;
       }
+      original_states.emplace_back(collect_dead_states());
     }
-    live_states_opt = live_states;
+    return {{std::move(new_states), alphabet, 0,
+             std::move(new_transition_function), std::move(new_final_states)},
+            std::move(original_states)};
   }
 
   DFA DFA::intersect(const DFA &rhs) const {
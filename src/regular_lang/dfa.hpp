@@ -8,6 +8,8 @@
 #pragma once
 
 #include "automaton/automaton.hpp"
+#include "instrumentation.hpp"
+#include "once_cache.hpp"
 
 namespace cyy::computation {
 
@@ -36,10 +38,17 @@ namespace cyy::computation {
     const auto &get_transition_function() const { return transition_function; }
     bool equivalent_with(const DFA &rhs) const;
 
+    //! Hopcroft-Karp language equivalence test, the DFAs need not be minimal.
+    //! Return a string accepted by exactly one of the DFAs if they differ.
+    std::optional<symbol_string> get_distinguishing_string(const DFA &rhs) const;
+    bool language_equivalent_with(const DFA &rhs) const {
+      return !get_distinguishing_string(rhs).has_value();
+    }
+
     bool recognize(symbol_string_view view) const {
       auto s = get_start_state();
-
       for (auto const &symbol : view) {
+        instrumentation::add(instrumentation::counter::DFA_step);
         auto opt_res = go(s, symbol);
         if (!opt_res) {
           return false;
@@ -50,6 +59,7 @@ namespace cyy::computation {
     }
 
     std::optional<state_type> go(state_type s, input_symbol_type a) const {
+      instrumentation::add(instrumentation::counter::DFA_transition_lookup);
       auto it = transition_function.find({s, a});
       if (it != transition_function.end()) {
         return {it->second};
@@ -57,16 +67,25 @@ namespace cyy::computation {
       return {};
     }
 
-    const state_set_type &get_live_states() const {
-      mark_live_states();
-      assert(live_states_opt.has_value());
-      return live_states_opt.value();
+    //! Bitset indexed by get_state_index, a state is live if some final state
+    //! is reachable from it
+    const state_bitset_type &get_live_state_bitset() const {
+      return live_state_bitset.get(
+          [this] { return compute_live_state_bitset(); });
     }
+    state_set_type get_live_states() const;
 
     bool is_live_state(state_type s) const {
-      return get_live_states().contains(s);
+      return get_live_state_bitset().test(get_state_index(s));
     }
 
+    //! Bitset indexed by get_state_index of the states that are reachable
+    //! from the start state and live
+    state_bitset_type get_useful_state_bitset() const;
+    //! Keep the useful states, all other transitions go to a single reject
+    //! state. The states of the result are renumbered from 0.
+    DFA trim() const;
+
     std::pair<DFA, std::vector<state_set_type>>
     minimize(std::vector<state_set_type> init_partition = {}) const;
 
@@ -76,9 +95,12 @@ namespace cyy::computation {
     [[nodiscard]] std::string MMA_draw() const;
 
   private:
-    void mark_live_states() const;
+    state_bitset_type compute_live_state_bitset() const;
+    state_bitset_type get_reachable_state_bitset() const;
+    //! trim() and the states of this DFA each trimmed state stands for
+    std::pair<DFA, std::vector<state_set_type>> trim_with_mapping() const;
 
-    mutable std::optional<state_set_type> live_states_opt;
+    once_cache<state_bitset_type> live_state_bitset;
     transition_function_type transition_function;
   };
 
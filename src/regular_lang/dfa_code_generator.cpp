@@ -0,0 +1,203 @@
+/*!
+ * \file dfa_code_generator.cpp
+ *
+ * \brief generate C++ matchers from DFAs
+ */
+
+#include "dfa_code_generator.hpp"
+
+#include <format>
+#include <map>
+
+#include "nfa.hpp"
+
+namespace cyy::computation {
+  namespace {
+    // DFA of Σ*L
+    DFA get_search_DFA(const DFA &dfa) {
+      NFA nfa(dfa);
+      auto const new_start_state = nfa.add_new_state();
+      nfa.add_epsilon_transition(new_start_state, {dfa.get_start_state()});
+      for (auto a : dfa.get_alphabet().get_view()) {
+        nfa.add_transition({new_start_state, a}, {new_start_state});
+      }
+      nfa.change_start_state(new_start_state);
+      return nfa.to_DFA();
+    }
+
+    template <typename T>
+    void append_list(std::string &code, const std::vector<T> &values,
+                     size_t line_size) {
+      for (size_t i = 0; i < values.size(); i++) {
+        if (i % line_size == 0) {
+          code += "\n        ";
+        }
+        code += std::format("{},", values[i]);
+      }
+    }
+  } // namespace
+
+  std::string generate_cpp_matcher(const DFA &dfa,
+                                   const matcher_generation_option &option) {
+    auto const matcher_dfa = (option.search_mode ? get_search_DFA(dfa) : dfa)
+                                 .minimize()
+                                 .first.trim();
+    auto const state_number = matcher_dfa.get_states().size();
+    auto const &alphabet = matcher_dfa.get_alphabet();
+
+    // symbols with the same next states share a class
+    auto symbols =
+        std::ranges::to<std::vector<symbol_type>>(alphabet.get_view());
+    std::ranges::sort(symbols);
+    std::map<std::vector<DFA::state_type>, size_t> column_to_class;
+    std::vector<size_t> symbol_classes;
+    std::vector<std::vector<DFA::state_type>> class_columns;
+    for (auto const a : symbols) {
+      std::vector<DFA::state_type> column;
+      column.reserve(state_number);
+      for (auto const s : matcher_dfa.get_states()) {
+        column.push_back(matcher_dfa.go(s, a).value());
+      }
+      auto [it, has_emplaced] =
+          column_to_class.try_emplace(column, class_columns.size());
+      if (has_emplaced) {
+        class_columns.emplace_back(std::move(column));
+      }
+      symbol_classes.push_back(it->second);
+    }
+    auto const class_number = class_columns.size();
+
+    // merge consecutive symbols of the same class into ranges
+    std::string symbol_ranges;
+    size_t range_number = 0;
+    for (size_t i = 0; i < symbols.size();) {
+      auto j = i + 1;
+      while (j < symbols.size() && symbols[j] == symbols[j - 1] + 1 &&
+             symbol_classes[j] == symbol_classes[i]) {
+        j++;
+      }
+      symbol_ranges += std::format("\n        {{{}, {}, {}}},",
+                                   static_cast<uint32_t>(symbols[i]),
+                                   static_cast<uint32_t>(symbols[j - 1]),
+                                   symbol_classes[i]);
+      range_number++;
+      i = j;
+    }
+
+    std::vector<DFA::state_type> transition_table;
+    transition_table.reserve(state_number * class_number);
+    std::vector<int> final_states;
+    std::string dead_state = "0xFFFFFFFF";
+    for (auto const s : matcher_dfa.get_states()) {
+      for (auto const &column : class_columns) {
+        transition_table.push_back(column[matcher_dfa.get_state_index(s)]);
+      }
+      final_states.push_back(matcher_dfa.is_final_state(s) ? 1 : 0);
+      if (!matcher_dfa.is_live_state(s)) {
+        dead_state = std::to_string(s);
+      }
+    }
+
+    auto const &function_name = option.function_name;
+    auto const detail_namespace = function_name + "_detail";
+    std::string code =
+        "// Generated by cyy::computation::generate_cpp_matcher, "
+        "do not edit.\n"
+        "#pragma once\n\n"
+        "#include <algorithm>\n"
+        "#include <array>\n"
+        "#include <cstddef>\n"
+        "#include <cstdint>\n"
+        "#include <functional>\n"
+        "#include <string_view>\n\n";
+    if (!option.namespace_name.empty()) {
+      code += std::format("namespace {} {{\n", option.namespace_name);
+    }
+    code += std::format("  namespace {} {{\n", detail_namespace);
+    code += "    struct symbol_range {\n"
+            "      char32_t first;\n"
+            "      char32_t last;\n"
+            "      std::uint32_t symbol_class;\n"
+            "    };\n";
+    code += std::format(
+        "    inline constexpr std::array<symbol_range, {}> symbol_ranges{{{{{}"
+        "\n    }}}};\n",
+        range_number, symbol_ranges);
+    code += std::format(
+        "    inline constexpr std::uint32_t class_number = {};\n"
+        "    inline constexpr std::uint32_t start_state = {};\n"
+        "    inline constexpr std::uint32_t dead_state = {};\n",
+        class_number, matcher_dfa.get_start_state(), dead_state);
+    code += std::format("    inline constexpr std::array<bool, {}> "
+                        "final_states{{",
+                        state_number);
+    append_list(code, final_states, 32);
+    code += "\n    };\n";
+    code += std::format("    inline constexpr std::array<std::uint32_t, {}> "
+                        "transition_table{{",
+                        transition_table.size());
+    append_list(code, transition_table, 16);
+    code += "\n    };\n";
+    code += "    constexpr std::uint32_t get_symbol_class(char32_t c) "
+            "noexcept {\n"
+            "      auto it = std::ranges::lower_bound(symbol_ranges, c, "
+            "std::less{}, &symbol_range::last);\n"
+            "      if (it == symbol_ranges.end() || c < it->first) {\n"
+            "        return class_number;\n"
+            "      }\n"
+            "      return it->symbol_class;\n"
+            "    }\n";
+    code += std::format("  }} // namespace {}\n\n", detail_namespace);
+
+    if (option.search_mode) {
+      code += std::format(
+          "  //! Return the end offset of the first substring in the "
+          "language,\n"
+          "  //! or npos if there is none\n"
+          "  constexpr std::size_t {}(std::u32string_view input) noexcept {{\n"
+          "    using namespace {};\n"
+          "    std::uint32_t state = start_state;\n"
+          "    if (final_states[state]) {{\n"
+          "      return 0;\n"
+          "    }}\n"
+          "    for (std::size_t i = 0; i < input.size(); i++) {{\n"
+          "      auto const symbol_class = get_symbol_class(input[i]);\n"
+          "      if (symbol_class == class_number) {{\n"
+          "        state = start_state;\n"
+          "        continue;\n"
+          "      }}\n"
+          "      state = transition_table[state * class_number + "
+          "symbol_class];\n"
+          "      if (final_states[state]) {{\n"
+          "        return i + 1;\n"
+          "      }}\n"
+          "    }}\n"
+          "    return std::u32string_view::npos;\n"
+          "  }}\n",
+          function_name, detail_namespace);
+    } else {
+      code += std::format(
+          "  constexpr bool {}(std::u32string_view input) noexcept {{\n"
+          "    using namespace {};\n"
+          "    std::uint32_t state = start_state;\n"
+          "    for (auto const c : input) {{\n"
+          "      auto const symbol_class = get_symbol_class(c);\n"
+          "      if (symbol_class == class_number) {{\n"
+          "        return false;\n"
+          "      }}\n"
+          "      state = transition_table[state * class_number + "
+          "symbol_class];\n"
+          "      if (state == dead_state) {{\n"
+          "        return false;\n"
+          "      }}\n"
+          "    }}\n"
+          "    return final_states[state];\n"
+          "  }}\n",
+          function_name, detail_namespace);
+    }
+    if (!option.namespace_name.empty()) {
+      code += std::format("}} // namespace {}\n", option.namespace_name);
+    }
+    return code;
+  }
+} // namespace cyy::computation
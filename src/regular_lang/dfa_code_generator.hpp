@@ -0,0 +1,27 @@
+/*!
+ * \file dfa_code_generator.hpp
+ *
+ * \brief generate C++ matchers from DFAs
+ */
+
+#pragma once
+
+#include <string>
+
+#include "dfa.hpp"
+
+namespace cyy::computation {
+  struct matcher_generation_option {
+    std::string function_name{"match"};
+    //! empty for the global namespace
+    std::string namespace_name;
+    //! Generate a function returning the end offset of the first substring in
+    //! the language instead of matching the whole input.
+    bool search_mode{false};
+  };
+
+  //! Emit a self-contained header with a constexpr transition table over
+  //! symbol classes, symbols with identical columns share one class.
+  std::string generate_cpp_matcher(const DFA &dfa,
+                                   const matcher_generation_option &option);
+} // namespace cyy::computation
@@ -0,0 +1,290 @@
+/*!
+ * \file dfa_statistics.cpp
+ *
+ * \brief count, enumerate and sample strings accepted by a DFA
+ */
+
+#include "dfa_statistics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace cyy::computation {
+  namespace {
+    // return matrix^exponent * vector, normalize is applied after each
+    // multiply-add
+    template <typename T, typename F>
+    std::vector<T> apply_matrix_power(std::vector<T> matrix,
+                                      std::vector<T> vector, size_t n,
+                                      uint64_t exponent, F normalize) {
+      auto multiply = [n, &normalize](const std::vector<T> &lhs,
+                                      const std::vector<T> &rhs, size_t m) {
+        std::vector<T> result(n * m, T(0));
+        for (size_t i = 0; i < n; i++) {
+          for (size_t k = 0; k < n; k++) {
+            auto const &a = lhs[(i * n) + k];
+            if (a == 0) {
+              continue;
+            }
+            for (size_t j = 0; j < m; j++) {
+              auto &c = result[(i * m) + j];
+              c = normalize(c + (a * rhs[(k * m) + j]));
+            }
+          }
+        }
+        return result;
+      };
+      while (exponent != 0) {
+        if ((exponent & 1) != 0) {
+          vector = multiply(matrix, vector, 1);
+        }
+        exponent >>= 1;
+        if (exponent != 0) {
+          matrix = multiply(matrix, matrix, n);
+        }
+      }
+      return vector;
+    }
+
+    // uniform in [0, bound) by rejection sampling on random bits
+    boost::multiprecision::cpp_int
+    uniform_below(const boost::multiprecision::cpp_int &bound,
+                  std::mt19937_64 &generator) {
+      auto const bit_number = boost::multiprecision::msb(bound) + 1;
+      while (true) {
+        boost::multiprecision::cpp_int value = 0;
+        for (size_t i = 0; i < bit_number; i += 64) {
+          value <<= 64;
+          value |= generator();
+        }
+        value >>= (64 - (bit_number % 64)) % 64;
+        if (value < bound) {
+          return value;
+        }
+      }
+    }
+  } // namespace
+
+  DFA_language_statistics::DFA_language_statistics(const DFA &dfa)
+      : start_state(
+            static_cast<uint32_t>(dfa.get_state_index(dfa.get_start_state()))) {
+    for (auto const a : dfa.get_alphabet().get_view()) {
+      symbols.push_back(a);
+    }
+    std::ranges::sort(symbols);
+    auto const &states = dfa.get_states();
+    table.reserve(states.size() * symbols.size());
+    for (auto const s : states) {
+      for (auto const a : symbols) {
+        table.push_back(
+            static_cast<uint32_t>(dfa.get_state_index(dfa.go(s, a).value())));
+      }
+      final_flags.push_back(dfa.is_final_state(s));
+      live_flags.push_back(dfa.is_live_state(s));
+    }
+  }
+
+  std::vector<std::vector<DFA_language_statistics::count_type>>
+  DFA_language_statistics::get_count_table(size_t length) const {
+    auto const state_number = final_flags.size();
+    std::vector<std::vector<count_type>> count_table;
+    count_table.reserve(length + 1);
+    count_table.emplace_back(state_number);
+    for (size_t s = 0; s < state_number; s++) {
+      count_table[0][s] = final_flags[s] ? 1 : 0;
+    }
+    for (size_t r = 1; r <= length; r++) {
+      std::vector<count_type> counts(state_number);
+      auto const &previous_counts = count_table.back();
+      for (uint32_t s = 0; s < state_number; s++) {
+        if (!live_flags[s]) {
+          continue;
+        }
+        for (size_t i = 0; i < symbols.size(); i++) {
+          counts[s] += previous_counts[go(s, i)];
+        }
+      }
+      count_table.emplace_back(std::move(counts));
+    }
+    return count_table;
+  }
+
+  std::vector<DFA_language_statistics::count_type>
+  DFA_language_statistics::count_up_to(size_t max_length) const {
+    std::vector<count_type> result;
+    result.reserve(max_length + 1);
+    for (auto &counts : get_count_table(max_length)) {
+      result.emplace_back(std::move(counts[start_state]));
+    }
+    return result;
+  }
+
+  DFA_language_statistics::count_type
+  DFA_language_statistics::count(uint64_t length) const {
+    auto const state_number = final_flags.size();
+    // dynamic programming costs length * |Q| * |Σ| and matrix exponentiation
+    // costs |Q|^3 * log(length)
+    if (static_cast<double>(length) * static_cast<double>(symbols.size()) <=
+        static_cast<double>(state_number * state_number) *
+            static_cast<double>(std::bit_width(length))) {
+      std::vector<count_type> counts(state_number);
+      std::vector<count_type> next_counts(state_number);
+      for (size_t s = 0; s < state_number; s++) {
+        counts[s] = final_flags[s] ? 1 : 0;
+      }
+      for (uint64_t r = 0; r < length; r++) {
+        for (uint32_t s = 0; s < state_number; s++) {
+          next_counts[s] = 0;
+          for (size_t i = 0; i < symbols.size(); i++) {
+            next_counts[s] += counts[go(s, i)];
+          }
+        }
+        std::swap(counts, next_counts);
+      }
+      return counts[start_state];
+    }
+    std::vector<count_type> matrix(state_number * state_number);
+    std::vector<count_type> vector(state_number);
+    for (uint32_t s = 0; s < state_number; s++) {
+      for (size_t i = 0; i < symbols.size(); i++) {
+        matrix[(s * state_number) + go(s, i)] += 1;
+      }
+      vector[s] = final_flags[s] ? 1 : 0;
+    }
+    return apply_matrix_power(std::move(matrix), std::move(vector),
+                              state_number, length,
+                              [](count_type c) { return c; })[start_state];
+  }
+
+  uint64_t DFA_language_statistics::count_modulo(uint64_t length,
+                                                 uint64_t modulus) const {
+    if (modulus == 0) {
+      throw std::invalid_argument("modulus is 0");
+    }
+    using wide_type = unsigned __int128;
+    auto const state_number = final_flags.size();
+    std::vector<wide_type> matrix(state_number * state_number);
+    std::vector<wide_type> vector(state_number);
+    for (uint32_t s = 0; s < state_number; s++) {
+      for (size_t i = 0; i < symbols.size(); i++) {
+        auto &entry = matrix[(s * state_number) + go(s, i)];
+        entry = (entry + 1) % modulus;
+      }
+      vector[s] = (final_flags[s] ? 1 : 0) % modulus;
+    }
+    // entries stay below the modulus, so a multiply-add fits in 128 bits
+    return static_cast<uint64_t>(apply_matrix_power(
+        std::move(matrix), std::move(vector), state_number, length,
+        [modulus](wide_type c) { return c % modulus; })[start_state]);
+  }
+
+  std::optional<symbol_string>
+  DFA_language_statistics::sample(size_t length,
+                                  std::mt19937_64 &generator) const {
+    auto const count_table = get_count_table(length);
+    if (count_table[length][start_state] == 0) {
+      return {};
+    }
+    symbol_string result;
+    result.reserve(length);
+    auto s = start_state;
+    for (size_t r = length; r > 0; r--) {
+      // choose a symbol with probability proportional to the completions
+      auto k = uniform_below(count_table[r][s], generator);
+      for (size_t i = 0; i < symbols.size(); i++) {
+        auto const &completion_count = count_table[r - 1][go(s, i)];
+        if (k < completion_count) {
+          result.push_back(symbols[i]);
+          s = go(s, i);
+          break;
+        }
+        k -= completion_count;
+      }
+    }
+    return result;
+  }
+
+  DFA_language_statistics::enumerator::enumerator(
+      const DFA_language_statistics &statistics_)
+      : statistics(&statistics_),
+        can_finish{statistics_.final_flags},
+        reachable_states(statistics_.final_flags.size(), false) {
+    reachable_states[statistics->start_state] = true;
+  }
+
+  bool DFA_language_statistics::enumerator::has_longer_strings() const {
+    for (size_t s = 0; s < reachable_states.size(); s++) {
+      if (reachable_states[s] && statistics->live_flags[s]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::optional<symbol_string> DFA_language_statistics::enumerator::next() {
+    auto const &symbols = statistics->symbols;
+    while (true) {
+      if (stack.empty()) {
+        if (started) {
+          length++;
+          std::vector<bool> next_reachable_states(reachable_states.size(),
+                                                  false);
+          for (uint32_t s = 0; s < reachable_states.size(); s++) {
+            if (reachable_states[s]) {
+              for (size_t i = 0; i < symbols.size(); i++) {
+                next_reachable_states[statistics->go(s, i)] = true;
+              }
+            }
+          }
+          reachable_states = std::move(next_reachable_states);
+          std::vector<bool> next_can_finish(reachable_states.size(), false);
+          for (uint32_t s = 0; s < reachable_states.size(); s++) {
+            for (size_t i = 0; i < symbols.size(); i++) {
+              if (can_finish.back()[statistics->go(s, i)]) {
+                next_can_finish[s] = true;
+                break;
+              }
+            }
+          }
+          can_finish.emplace_back(std::move(next_can_finish));
+        }
+        started = true;
+        if (!has_longer_strings()) {
+          return {};
+        }
+        if (!can_finish[length][statistics->start_state]) {
+          continue;
+        }
+        prefix.clear();
+        stack.emplace_back(statistics->start_state, 0);
+      }
+
+      if (prefix.size() == length) {
+        auto result = prefix;
+        stack.pop_back();
+        if (!prefix.empty()) {
+          prefix.pop_back();
+        }
+        return result;
+      }
+      auto &[s, symbol_index] = stack.back();
+      auto const &next_can_finish = can_finish[length - prefix.size() - 1];
+      while (symbol_index < symbols.size() &&
+             !next_can_finish[statistics->go(s, symbol_index)]) {
+        symbol_index++;
+      }
+      if (symbol_index == symbols.size()) {
+        stack.pop_back();
+        if (!prefix.empty()) {
+          prefix.pop_back();
+        }
+        continue;
+      }
+      auto const next_state = statistics->go(s, symbol_index);
+      prefix.push_back(symbols[symbol_index]);
+      symbol_index++;
+      stack.emplace_back(next_state, 0);
+    }
+  }
+} // namespace cyy::computation
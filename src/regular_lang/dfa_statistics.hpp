@@ -0,0 +1,75 @@
+/*!
+ * \file dfa_statistics.hpp
+ *
+ * \brief count, enumerate and sample strings accepted by a DFA
+ */
+
+#pragma once
+
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "dfa.hpp"
+
+namespace cyy::computation {
+  //! Queries run over a dense copy of the transition table, states are
+  //! renumbered to their indices and symbols are sorted.
+  class DFA_language_statistics {
+  public:
+    using count_type = boost::multiprecision::cpp_int;
+    explicit DFA_language_statistics(const DFA &dfa);
+
+    //! Number of accepted strings of the length, computed by dynamic
+    //! programming or by matrix exponentiation for long lengths
+    count_type count(uint64_t length) const;
+    //! Numbers of accepted strings of lengths 0 ... max_length
+    std::vector<count_type> count_up_to(size_t max_length) const;
+    //! Number of accepted strings of the length modulo the modulus, by
+    //! matrix exponentiation
+    uint64_t count_modulo(uint64_t length, uint64_t modulus) const;
+
+    //! A uniformly random accepted string of the length if there is any
+    std::optional<symbol_string> sample(size_t length,
+                                        std::mt19937_64 &generator) const;
+
+    //! Yield accepted strings by length, then in lexicographic order
+    class enumerator {
+    public:
+      std::optional<symbol_string> next();
+
+    private:
+      friend class DFA_language_statistics;
+      explicit enumerator(const DFA_language_statistics &statistics_);
+      bool has_longer_strings() const;
+
+      const DFA_language_statistics *statistics;
+      size_t length{0};
+      //! can_finish[r][s] is true if s reaches a final state in r steps
+      std::vector<std::vector<bool>> can_finish;
+      //! states reachable from the start state in length steps
+      std::vector<bool> reachable_states;
+      //! DFS frames of state and next symbol index
+      std::vector<std::pair<uint32_t, size_t>> stack;
+      symbol_string prefix;
+      bool started{false};
+    };
+    enumerator enumerate() const { return enumerator(*this); }
+
+  private:
+    uint32_t go(uint32_t s, size_t symbol_index) const noexcept {
+      return table[(s * symbols.size()) + symbol_index];
+    }
+    //! Numbers of accepted strings of length r from each state, r <= length
+    std::vector<std::vector<count_type>>
+    get_count_table(size_t length) const;
+
+    std::vector<symbol_type> symbols;
+    uint32_t start_state{};
+    std::vector<uint32_t> table;
+    std::vector<bool> final_flags;
+    std::vector<bool> live_flags;
+  };
+} // namespace cyy::computation
@@ -0,0 +1,216 @@
+/*!
+ * \file frozen_nfa.cpp
+ *
+ * \brief read-only NFA stored in compressed sparse rows
+ */
+
+#include "frozen_nfa.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "arena.hpp"
+
+namespace cyy::computation {
+  frozen_NFA::frozen_NFA(const NFA &nfa)
+      : alphabet(nfa.get_alphabet_ptr()),
+        original_states(nfa.get_states().begin(), nfa.get_states().end()),
+        final_flags(nfa.get_states().size()) {
+    auto const state_number = original_states.size();
+    auto index = [&nfa](finite_automaton::state_type s) {
+      return static_cast<state_type>(nfa.get_state_index(s));
+    };
+    start_state = index(nfa.get_start_state());
+    for (auto const s : nfa.get_final_states()) {
+      final_flags.set(index(s));
+    }
+
+    struct edge {
+      state_type from;
+      symbol_type symbol;
+      state_type to;
+    };
+    std::vector<edge> edges;
+    for (auto const &[situation, next_states] : nfa.get_transition_function()) {
+      for (auto const next_state : next_states) {
+        edges.emplace_back(index(situation.state), situation.input_symbol,
+                           index(next_state));
+      }
+    }
+    std::ranges::sort(edges, {}, [](const edge &e) {
+      return std::tuple(e.from, e.symbol, e.to);
+    });
+    edge_offsets.assign(state_number + 1, 0);
+    edge_symbols.reserve(edges.size());
+    edge_targets.reserve(edges.size());
+    for (auto const &e : edges) {
+      edge_offsets[e.from + 1]++;
+      edge_symbols.push_back(e.symbol);
+      edge_targets.push_back(e.to);
+    }
+    std::partial_sum(edge_offsets.begin(), edge_offsets.end(),
+                     edge_offsets.begin());
+
+    std::vector<std::pair<state_type, state_type>> epsilon_edges;
+    for (auto const &[from_state, next_states] :
+         nfa.get_epsilon_transition_function()) {
+      for (auto const next_state : next_states) {
+        if (from_state != next_state) {
+          epsilon_edges.emplace_back(index(from_state), index(next_state));
+        }
+      }
+    }
+    std::ranges::sort(epsilon_edges);
+    epsilon_offsets.assign(state_number + 1, 0);
+    epsilon_targets.reserve(epsilon_edges.size());
+    for (auto const &[from_state, next_state] : epsilon_edges) {
+      epsilon_offsets[from_state + 1]++;
+      epsilon_targets.push_back(next_state);
+    }
+    std::partial_sum(epsilon_offsets.begin(), epsilon_offsets.end(),
+                     epsilon_offsets.begin());
+  }
+
+  std::span<const frozen_NFA::state_type>
+  frozen_NFA::get_next_states(state_type s, symbol_type a) const noexcept {
+    instrumentation::add(instrumentation::counter::NFA_transition_lookup);
+    auto const row_begin = edge_symbols.begin() + edge_offsets[s];
+    auto const row_end = edge_symbols.begin() + edge_offsets[s + 1];
+    auto const [first, last] = std::equal_range(row_begin, row_end, a);
+    return {edge_targets.data() + (first - edge_symbols.begin()),
+            static_cast<size_t>(last - first)};
+  }
+
+  template <typename list_type>
+  void frozen_NFA::add_epsilon_closure(
+      list_type &states, finite_automaton::state_bitset_type &visited) const {
+    for (size_t i = 0; i < states.size(); i++) {
+      auto const s = states[i];
+      for (auto j = epsilon_offsets[s]; j < epsilon_offsets[s + 1]; j++) {
+        auto const next_state = epsilon_targets[j];
+        if (!visited.test_set(next_state)) {
+          states.push_back(next_state);
+        }
+      }
+    }
+  }
+
+  void frozen_NFA::step(std::span<const state_type> T, symbol_type a,
+                        scratch_list_type &result,
+                        finite_automaton::state_bitset_type &visited) const {
+    instrumentation::add(instrumentation::counter::NFA_step);
+    result.clear();
+    for (auto const s : T) {
+      for (auto const next_state : get_next_states(s, a)) {
+        if (!visited.test_set(next_state)) {
+          result.push_back(next_state);
+        }
+      }
+    }
+    add_epsilon_closure(result, visited);
+    // only clear the touched bits so that a step costs O(|result|)
+    for (auto const s : result) {
+      visited.reset(s);
+    }
+  }
+
+  frozen_NFA::state_list_type frozen_NFA::get_start_set() const {
+    finite_automaton::state_bitset_type visited(get_state_number());
+    visited.set(start_state);
+    state_list_type result{start_state};
+    add_epsilon_closure(result, visited);
+    std::ranges::sort(result);
+    return result;
+  }
+
+  frozen_NFA::state_list_type frozen_NFA::go(std::span<const state_type> T,
+                                             symbol_type a) const {
+    finite_automaton::state_bitset_type visited(get_state_number());
+    scratch_list_type next(std::pmr::get_default_resource());
+    step(T, a, next, visited);
+    std::ranges::sort(next);
+    return {next.begin(), next.end()};
+  }
+
+  bool frozen_NFA::recognize(symbol_string_view view) const {
+    finite_automaton::state_bitset_type visited(get_state_number());
+    // the two buffers are reused for the whole input
+    auto *resource = std::pmr::get_default_resource();
+    scratch_list_type current({start_state}, resource);
+    visited.set(start_state);
+    add_epsilon_closure(current, visited);
+    for (auto const s : current) {
+      visited.reset(s);
+    }
+    scratch_list_type next(resource);
+    for (auto const symbol : view) {
+      step(current, symbol, next, visited);
+      if (next.empty()) {
+        return false;
+      }
+      std::swap(current, next);
+    }
+    return std::ranges::any_of(current,
+                               [this](auto s) { return is_final_state(s); });
+  }
+
+  DFA frozen_NFA::to_DFA() const {
+    auto *resource = get_scratch_resource();
+    std::pmr::unordered_map<scratch_list_type, DFA::state_type,
+                            boost::hash<scratch_list_type>>
+        subset_to_state(resource);
+    std::pmr::vector<const scratch_list_type *> subsets(resource);
+    // keys are copied into the map nodes only for new subsets
+    auto add_subset = [&](const scratch_list_type &subset) {
+      auto [it, has_emplaced] =
+          subset_to_state.try_emplace(subset, subsets.size());
+      if (has_emplaced) {
+        instrumentation::add(
+            instrumentation::counter::subset_construction_state);
+        subsets.push_back(&it->first);
+      }
+      return it->second;
+    };
+    auto const start_set = get_start_set();
+    add_subset(scratch_list_type(start_set.begin(), start_set.end(), resource));
+
+    DFA::transition_function_type DFA_transition_function;
+    finite_automaton::state_bitset_type visited(get_state_number());
+    scratch_list_type next(resource);
+    for (DFA::state_type dfa_state = 0; dfa_state < subsets.size();
+         dfa_state++) {
+      for (auto a : alphabet->get_view()) {
+        step(*subsets[dfa_state], a, next, visited);
+        std::ranges::sort(next);
+        DFA_transition_function[{dfa_state, a}] = add_subset(next);
+      }
+    }
+
+    DFA::state_set_type DFA_states;
+    DFA::state_set_type DFA_final_states;
+    for (DFA::state_type dfa_state = 0; dfa_state < subsets.size();
+         dfa_state++) {
+      DFA_states.insert(DFA_states.end(), dfa_state);
+      if (std::ranges::any_of(*subsets[dfa_state],
+                              [this](auto s) { return is_final_state(s); })) {
+        DFA_final_states.insert(DFA_final_states.end(), dfa_state);
+      }
+    }
+    return {std::move(DFA_states), alphabet, 0,
+            std::move(DFA_transition_function), std::move(DFA_final_states)};
+  }
+
+  size_t frozen_NFA::get_memory_usage() const noexcept {
+    return (original_states.capacity() * sizeof(finite_automaton::state_type)) +
+           (final_flags.num_blocks() *
+            sizeof(finite_automaton::state_bitset_type::block_type)) +
+           ((edge_offsets.capacity() + epsilon_offsets.capacity()) *
+            sizeof(uint32_t)) +
+           (edge_symbols.capacity() * sizeof(symbol_type)) +
+           ((edge_targets.capacity() + epsilon_targets.capacity()) *
+            sizeof(state_type));
+  }
+} // namespace cyy::computation
@@ -0,0 +1,68 @@
+/*!
+ * \file frozen_nfa.hpp
+ *
+ * \brief read-only NFA stored in compressed sparse rows
+ */
+
+#pragma once
+
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "nfa.hpp"
+
+namespace cyy::computation {
+  //! States are renumbered to their indices in the NFA state set. The edges
+  //! of state s are [edge_offsets[s], edge_offsets[s + 1]) sorted by symbol
+  //! and next state, epsilon edges are kept in separate rows. Only to_DFA
+  //! allocates from the arena, queries may run inside an arena_scope without
+  //! growing it.
+  class frozen_NFA {
+  public:
+    using state_type = uint32_t;
+    using state_list_type = std::vector<state_type>;
+    explicit frozen_NFA(const NFA &nfa);
+
+    size_t get_state_number() const noexcept { return original_states.size(); }
+    finite_automaton::state_type
+    get_original_state(state_type s) const noexcept {
+      return original_states[s];
+    }
+    const ALPHABET &get_alphabet() const noexcept { return *alphabet; }
+    bool is_final_state(state_type s) const noexcept { return final_flags[s]; }
+
+    //! Sorted states of the epsilon closure of the start state
+    state_list_type get_start_set() const;
+    //! Sorted states reachable from T by a and epsilon transitions
+    state_list_type go(std::span<const state_type> T, symbol_type a) const;
+    bool recognize(symbol_string_view view) const;
+    //! Subset construction, numbers DFA states like NFA::to_DFA
+    DFA to_DFA() const;
+
+    //! Bytes used by the rows
+    size_t get_memory_usage() const noexcept;
+
+  private:
+    std::span<const state_type> get_next_states(state_type s,
+                                                symbol_type a) const noexcept;
+    using scratch_list_type = std::pmr::vector<state_type>;
+    //! Append states reachable by epsilon transitions from states
+    template <typename list_type>
+    void add_epsilon_closure(list_type &states,
+                             finite_automaton::state_bitset_type &visited) const;
+    void step(std::span<const state_type> T, symbol_type a,
+              scratch_list_type &result,
+              finite_automaton::state_bitset_type &visited) const;
+
+    ALPHABET_ptr alphabet;
+    state_type start_state{};
+    std::vector<finite_automaton::state_type> original_states;
+    finite_automaton::state_bitset_type final_flags;
+    std::vector<uint32_t> edge_offsets;
+    std::vector<symbol_type> edge_symbols;
+    std::vector<state_type> edge_targets;
+    std::vector<uint32_t> epsilon_offsets;
+    std::vector<state_type> epsilon_targets;
+  };
+} // namespace cyy::computation
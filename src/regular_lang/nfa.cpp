@@ -7,7 +7,9 @@
 
 #include "nfa.hpp"
 
-#include <cyy/algorithm/graph/graph.hpp>
+#include <map>
+
+#include "frozen_nfa.hpp"
 
 namespace cyy::computation {
 
@@ -15,36 +17,35 @@ namespace cyy::computation {
                               input_symbol_type a) const {
     state_set_type direct_reachable;
 
+    instrumentation::add(instrumentation::counter::NFA_step);
+    instrumentation::add(instrumentation::counter::NFA_transition_lookup,
+                         T.size());
     for (const auto &s : T) {
       auto it = transition_function.find({s, a});
       if (it != transition_function.end()) {
-        direct_reachable.merge(state_set_type(it->second));
+        direct_reachable.merge(it->second);
       }
     }
 
     state_set_type res;
     for (auto const &d : direct_reachable) {
-      auto const &closure = get_epsilon_closure(d);
-      res.merge(state_set_type(closure));
+      add_epsilon_closure(d, res);
     }
     return res;
   }
   bool NFA::recognize(symbol_string_view view) const {
-    auto s = get_epsilon_closure(get_start_state());
-    for (auto const &symbol : view) {
-      s = go(s, symbol);
-      if (s.empty()) {
-        return false;
-      }
-    }
-    return contain_final_state(s);
+    return get_frozen_NFA().recognize(view);
+  }
+
+  const frozen_NFA &NFA::get_frozen_NFA() const {
+    return frozen.get([this] { return frozen_NFA(*this); });
   }
 
   std::pair<DFA, boost::bimap<NFA::state_set_type, DFA::state_type>>
   NFA::to_DFA_with_mapping() const {
     DFA::transition_function_type DFA_transition_function;
     boost::bimap<state_set_type, state_type> nfa_and_dfa_states;
-    nfa_and_dfa_states.insert({get_epsilon_closure(get_start_state()), 0});
+    nfa_and_dfa_states.insert({get_start_set(), 0});
 
     state_type next_state = 1;
     std::vector iteraters{nfa_and_dfa_states.begin()};
@@ -54,6 +55,8 @@ namespace cyy::computation {
         auto res = go(subset, a);
         auto [it, has_emplaced] = nfa_and_dfa_states.insert({res, next_state});
         if (has_emplaced) {
+          instrumentation::add(
+              instrumentation::counter::subset_construction_state);
           iteraters.emplace_back(it);
           next_state++;
         }
@@ -75,7 +78,154 @@ namespace cyy::computation {
         nfa_and_dfa_states};
   }
 
-  DFA NFA::to_DFA() const { return to_DFA_with_mapping().first; }
+  DFA NFA::to_DFA() const { return get_frozen_NFA().to_DFA(); }
+
+  NFA NFA::remove_epsilon_transitions() const {
+    std::unordered_map<state_type,
+                       std::vector<transition_function_type::const_pointer>>
+        outgoing_transitions;
+    for (auto const &transition : transition_function) {
+      outgoing_transitions[transition.first.state].push_back(&transition);
+    }
+    transition_function_type new_transition_function;
+    state_set_type new_final_states;
+    for (auto const s : get_states()) {
+      state_set_type closure;
+      add_epsilon_closure(s, closure);
+      if (contain_final_state(closure)) {
+        new_final_states.insert(s);
+      }
+      for (auto const closure_state : closure) {
+        auto it = outgoing_transitions.find(closure_state);
+        if (it == outgoing_transitions.end()) {
+          continue;
+        }
+        for (auto const *transition : it->second) {
+          new_transition_function[{s, transition->first.input_symbol}].merge(
+              transition->second);
+        }
+      }
+    }
+    return {get_states(), alphabet, get_start_state(),
+            std::move(new_transition_function), std::move(new_final_states)};
+  }
+
+  NFA NFA::reduce() const {
+    auto const nfa = epsilon_transition_function.empty()
+                         ? *this
+                         : remove_epsilon_transitions();
+    auto const &nfa_transition_function = nfa.transition_function;
+
+    // useful states are reachable from the start state and reach final states
+    state_set_map_type successors;
+    state_set_map_type predecessors;
+    for (auto const &[situation, next_states] : nfa_transition_function) {
+      for (auto const next_state : next_states) {
+        successors[situation.state].insert(next_state);
+        predecessors[next_state].insert(situation.state);
+      }
+    }
+    auto search = [](std::vector<state_type> queue,
+                     const state_set_map_type &edges) {
+      state_set_type visited(queue.begin(), queue.end());
+      while (!queue.empty()) {
+        auto const s = queue.back();
+        queue.pop_back();
+        auto it = edges.find(s);
+        if (it == edges.end()) {
+          continue;
+        }
+        for (auto const next_state : it->second) {
+          if (visited.insert(next_state).second) {
+            queue.push_back(next_state);
+          }
+        }
+      }
+      return visited;
+    };
+    auto const reachable_states = search({get_start_state()}, successors);
+    // a final state entered only through epsilon transitions has no
+    // predecessor after they are removed
+    auto const &nfa_final_states = nfa.get_final_states();
+    auto const coreachable_states =
+        search(std::vector<state_type>(nfa_final_states.begin(),
+                                       nfa_final_states.end()),
+               predecessors);
+    state_set_type useful_states;
+    std::ranges::set_intersection(
+        reachable_states, coreachable_states,
+        std::insert_iterator(useful_states, useful_states.begin()));
+    useful_states.insert(get_start_state());
+
+    // partition refinement, states are bisimilar if they agree on finality
+    // and reach the same blocks by the same symbols
+    std::unordered_map<state_type, size_t> block_of;
+    for (auto const s : useful_states) {
+      block_of[s] = nfa.is_final_state(s) ? 1 : 0;
+    }
+    size_t block_number = 0;
+    while (true) {
+      using signature_type =
+          std::pair<size_t, std::vector<std::pair<symbol_type, size_t>>>;
+      std::unordered_map<state_type, signature_type> signatures;
+      for (auto const &[situation, next_states] : nfa_transition_function) {
+        if (!useful_states.contains(situation.state)) {
+          continue;
+        }
+        auto &edges = signatures[situation.state].second;
+        for (auto const next_state : next_states) {
+          if (useful_states.contains(next_state)) {
+            edges.emplace_back(situation.input_symbol, block_of[next_state]);
+          }
+        }
+      }
+      std::map<signature_type, size_t> signature_to_block;
+      std::unordered_map<state_type, size_t> new_block_of;
+      for (auto const s : useful_states) {
+        auto &signature = signatures[s];
+        signature.first = block_of[s];
+        std::ranges::sort(signature.second);
+        auto [first, last] = std::ranges::unique(signature.second);
+        signature.second.erase(first, last);
+        auto const it =
+            signature_to_block
+                .try_emplace(std::move(signature), signature_to_block.size())
+                .first;
+        new_block_of[s] = it->second;
+      }
+      block_of = std::move(new_block_of);
+      if (signature_to_block.size() == block_number) {
+        break;
+      }
+      block_number = signature_to_block.size();
+    }
+
+    state_set_type reduced_states;
+    state_set_type reduced_final_states;
+    transition_function_type reduced_transition_function;
+    for (auto const s : useful_states) {
+      auto const block = block_of[s];
+      reduced_states.insert(block);
+      if (nfa.is_final_state(s)) {
+        reduced_final_states.insert(block);
+      }
+    }
+    for (auto const &[situation, next_states] : nfa_transition_function) {
+      if (!useful_states.contains(situation.state)) {
+        continue;
+      }
+      for (auto const next_state : next_states) {
+        if (useful_states.contains(next_state)) {
+          reduced_transition_function[{block_of[situation.state],
+                                       situation.input_symbol}]
+              .insert(block_of[next_state]);
+        }
+      }
+    }
+    return {std::move(reduced_states), alphabet, block_of[get_start_state()],
+            std::move(reduced_transition_function),
+            std::move(reduced_final_states)};
+  }
 
   std::string NFA::MMA_draw() const {
     std::stringstream is;
@@ -99,52 +249,43 @@ namespace cyy::computation {
     return is.str();
   }
 
-  const NFA::state_set_type &NFA::get_epsilon_closure(state_type s) const {
-    if (epsilon_closure_refresh.contains(s)) {
-      return epsilon_closures[s];
-    }
-
-    if (!epsilon_transition_function.contains(s)) {
-      epsilon_closure_refresh.insert(s);
-      epsilon_closures[s].insert(s);
-      return epsilon_closures[s];
+  void NFA::add_epsilon_closure(state_type s,
+                                state_set_type &state_set) const {
+    instrumentation::add(instrumentation::counter::NFA_epsilon_closure_lookup);
+    auto const &closures =
+        epsilon_closures.get([this] { return compute_epsilon_closures(); });
+    auto it = closures.find(s);
+    if (it == closures.end()) {
+      state_set.insert(s);
+      return;
     }
+    state_set.merge(it->second);
+  }
 
-    cyy::algorithm::directed_graph<state_type> epsilon_graph;
-    for (const auto &[from_state, to_state_set] : epsilon_transition_function) {
-      for (auto to_state : to_state_set) {
-        if (from_state != to_state) {
-          epsilon_graph.add_edge({from_state, to_state});
+  NFA::state_set_map_type NFA::compute_epsilon_closures() const {
+    instrumentation::add(
+        instrumentation::counter::NFA_epsilon_closure_computation);
+    state_set_map_type closures;
+    std::vector<state_type> stack;
+    for (auto const &[from_state, _] : epsilon_transition_function) {
+      state_set_type closure{from_state};
+      stack.push_back(from_state);
+      while (!stack.empty()) {
+        auto const state = stack.back();
+        stack.pop_back();
+        auto it = epsilon_transition_function.find(state);
+        if (it == epsilon_transition_function.end()) {
+          continue;
         }
-      }
-    }
-    const auto s_index = epsilon_graph.get_vertex_index(s);
-    bool has_cycle = false;
-    state_set_type connect_component;
-    epsilon_graph.recursive_depth_first_search(
-        s_index,
-        [this, &epsilon_graph, &has_cycle, &connect_component](auto u, auto v) {
-          auto u_vertex = epsilon_graph.get_vertex(u);
-          connect_component.insert(u_vertex);
-          auto v_vertex = epsilon_graph.get_vertex(v);
-          if (connect_component.contains(v_vertex)) {
-            has_cycle = true;
-          } else {
-            connect_component.insert(v_vertex);
+        for (auto const next_state : it->second) {
+          if (closure.insert(next_state).second) {
+            stack.push_back(next_state);
           }
-          auto &closure = epsilon_closures[u_vertex];
-          auto &v_closure = epsilon_closures[v_vertex];
-          closure.insert(u_vertex);
-          v_closure.insert(v_vertex);
-          closure.merge(state_set_type(epsilon_closures[v_vertex]));
-          return false;
-        });
-    if (!has_cycle) {
-      epsilon_closure_refresh.merge(connect_component);
+        }
+      }
+      closures.emplace(from_state, std::move(closure));
     }
-    epsilon_closure_refresh.insert(s);
-
-    return epsilon_closures[s];
+    return closures;
   }
 
 } // namespace cyy::computation
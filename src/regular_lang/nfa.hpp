@@ -9,9 +9,11 @@
 
 #include <boost/bimap.hpp>
 
+#include "once_cache.hpp"
 #include "dfa.hpp"
 
 namespace cyy::computation {
+  class frozen_NFA;
 
   class NFA final : public finite_automaton {
   public:
@@ -61,6 +63,47 @@ namespace cyy::computation {
       for (auto &[from_state, to_state_set] : rhs.epsilon_transition_function) {
         epsilon_transition_function[from_state].merge(std::move(to_state_set));
       }
+      epsilon_closures.reset();
+      frozen.reset();
+    }
+
+    // the state changes of finite_automaton also drop the frozen NFA
+    void set_alphabet(ALPHABET_ptr alphabet_) noexcept {
+      finite_automaton::set_alphabet(std::move(alphabet_));
+      frozen.reset();
+    }
+    void replace_final_states(state_type s) {
+      finite_automaton::replace_final_states(s);
+      frozen.reset();
+    }
+    state_type add_new_state() {
+      frozen.reset();
+      return finite_automaton::add_new_state();
+    }
+    bool add_new_state(state_type s) {
+      frozen.reset();
+      return finite_automaton::add_new_state(s);
+    }
+    template <std::ranges::range U> void add_new_states(U state_set) {
+      finite_automaton::add_new_states(std::move(state_set));
+      frozen.reset();
+    }
+    void change_start_state(state_type s) {
+      finite_automaton::change_start_state(s);
+      frozen.reset();
+    }
+    void clear_final_states() {
+      finite_automaton::clear_final_states();
+      frozen.reset();
+    }
+    void add_final_state(state_type s) {
+      finite_automaton::add_final_state(s);
+      frozen.reset();
+    }
+    template <std::ranges::range U>
+    void change_final_states(U new_final_states) {
+      finite_automaton::change_final_states(std::move(new_final_states));
+      frozen.reset();
     }
 
     auto const &get_transition_function() const noexcept {
@@ -89,6 +132,7 @@ namespace cyy::computation {
         }
       }
       transition_function[situation].merge(end_states);
+      frozen.reset();
     }
 
     void add_epsilon_transition(state_type from_state,
@@ -104,10 +148,11 @@ namespace cyy::computation {
         }
       }
       epsilon_transition_function[from_state].merge(end_states);
-      epsilon_closures.clear();
-      epsilon_closure_refresh.clear();
+      epsilon_closures.reset();
+      frozen.reset();
     }
 
+    //! Simulates the frozen NFA, which is built once after each mutation
     bool recognize(symbol_string_view view) const;
 
     // use subset construction
@@ -115,20 +160,38 @@ namespace cyy::computation {
     to_DFA_with_mapping() const;
     DFA to_DFA() const;
 
+    //! Equivalent NFA without epsilon transitions, each state takes the
+    //! transitions and finality of its epsilon closure
+    NFA remove_epsilon_transitions() const;
+    //! Remove epsilon transitions and states that are unreachable or can't
+    //! reach final states, then merge forward bisimilar states
+    NFA reduce() const;
+
     [[nodiscard]] std::string MMA_draw() const;
 
-    const state_set_type &get_start_set() const {
-      return get_epsilon_closure(get_start_state());
+    state_set_type get_start_set() const {
+      state_set_type start_set;
+      add_epsilon_closure(get_start_state(), start_set);
+      return start_set;
     }
+    //! A single step over the transition maps, repeated steps should use
+    //! frozen_NFA
     state_set_type go(const state_set_type &T, input_symbol_type a) const;
 
   private:
-    const state_set_type &get_epsilon_closure(state_type s) const;
+    //! Merge the epsilon closure of s into state_set, safe for concurrent use
+    void add_epsilon_closure(state_type s, state_set_type &state_set) const;
+    state_set_map_type compute_epsilon_closures() const;
+    const frozen_NFA &get_frozen_NFA() const;
 
     transition_function_type transition_function;
     epsilon_transition_function_type epsilon_transition_function;
-    mutable state_set_map_type epsilon_closures;
-    mutable state_set_type epsilon_closure_refresh;
+    //! closures of states having epsilon transitions, their total size is
+    //! quadratic in the number of states for long epsilon chains
+    once_cache<state_set_map_type> epsilon_closures;
+    //! compressed sparse rows for recognize and to_DFA, kept in addition to
+    //! the transition maps
+    once_cache<frozen_NFA> frozen;
   };
 
 } // namespace cyy::computation
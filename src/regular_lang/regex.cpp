@@ -7,66 +7,90 @@
 
 #include "regex.hpp"
 
+#include <boost/container_hash/hash.hpp>
+
+#include "arena.hpp"
+
 namespace cyy::computation {
 
   DFA regex::to_DFA() const {
     std::unordered_map<uint64_t, symbol_type> position_to_symbol;
 
-    regex::concat_node syntax_tree_with_endmarker(
+    regex::concat_node const syntax_tree_with_endmarker(
         syntax_tree, std::make_shared<regex::basic_node>(ALPHABET::endmarker));
 
-    syntax_tree_with_endmarker.assign_position(position_to_symbol);
+    // the shared tree is not modified, so concurrent calls are safe
+    position_map_type positions;
+    syntax_tree_with_endmarker.assign_position(positions, position_to_symbol);
 
     auto final_position =
         std::ranges::max(std::views::keys(position_to_symbol));
-    auto follow_pos_table = syntax_tree_with_endmarker.follow_pos();
+    auto follow_pos_table = syntax_tree_with_endmarker.follow_pos(positions);
 
-    std::vector<bool> flags{false};
-    std::vector<std::unordered_set<uint64_t>> position_sets{
-        syntax_tree_with_endmarker.first_pos()};
-    DFA::state_set_type DFA_states{0};
+    // position sets are kept sorted so that they can be hashed
+    using position_set_type = std::pmr::vector<uint64_t>;
+    auto *resource = get_scratch_resource();
+    std::pmr::unordered_map<position_set_type, DFA::state_type,
+                            boost::hash<position_set_type>>
+        position_set_to_state(resource);
+    std::pmr::vector<const position_set_type *> position_sets(resource);
+    auto add_position_set = [&](const position_set_type &position_set) {
+      auto [it, has_emplaced] = position_set_to_state.try_emplace(
+          position_set, position_sets.size());
+      if (has_emplaced) {
+        instrumentation::add(instrumentation::counter::regex_to_DFA_state);
+        position_sets.push_back(&it->first);
+      }
+      return it->second;
+    };
+    {
+      auto const first_pos = syntax_tree_with_endmarker.first_pos(positions);
+      position_set_type start_set(first_pos.begin(), first_pos.end(), resource);
+      std::ranges::sort(start_set);
+      add_position_set(start_set);
+    }
+
+    DFA::state_set_type DFA_states;
     DFA::transition_function_type DFA_transition_function;
     DFA::state_set_type DFA_final_states;
-    for (size_t i = 0; i < flags.size(); i++) {
-      if (flags[i]) {
-        continue;
+    std::pmr::unordered_map<symbol_type, position_set_type> symbol_follow_pos(
+        resource);
+    for (DFA::state_type i = 0; i < position_sets.size(); i++) {
+      DFA_states.insert(DFA_states.end(), i);
+      // group the follow positions by symbol in one pass over the set
+      for (auto &[_, follow_pos_set] : symbol_follow_pos) {
+        follow_pos_set.clear();
       }
-      flags[i] = true;
-
-      for (auto a : alphabet->get_view()) {
-        std::unordered_set<uint64_t> follow_pos_set;
-        for (auto const pos : position_sets[i]) {
-          if (position_to_symbol[pos] == a) {
-            for (auto const follow_pos : follow_pos_table[pos]) {
-              follow_pos_set.insert(follow_pos);
-            }
-          }
-        }
-
-        size_t j = 0;
-        for (j = 0; j < flags.size(); j++) {
-          if (position_sets[j] == follow_pos_set) {
-            break;
-          }
-        }
-
-        // new state
-        if (j == flags.size()) {
-          position_sets.push_back(follow_pos_set);
-          flags.push_back(false);
-          DFA_states.insert(j);
+      for (auto const pos : *position_sets[i]) {
+        auto it = follow_pos_table.find(pos);
+        if (it == follow_pos_table.end()) {
+          continue;
         }
+        auto &follow_pos_set = symbol_follow_pos[position_to_symbol[pos]];
+        follow_pos_set.insert(follow_pos_set.end(), it->second.begin(),
+                              it->second.end());
+      }
+      for (auto &[_, follow_pos_set] : symbol_follow_pos) {
+        std::ranges::sort(follow_pos_set);
+        auto [first, last] = std::ranges::unique(follow_pos_set);
+        follow_pos_set.erase(first, last);
+      }
 
-        DFA_transition_function[{i, a}] = j;
+      position_set_type const empty_set(resource);
+      for (auto a : alphabet->get_view()) {
+        auto it = symbol_follow_pos.find(a);
+        DFA_transition_function[{i, a}] = add_position_set(
+            it == symbol_follow_pos.end() ? empty_set : it->second);
       }
     }
 
-    for (size_t i = 0; i < position_sets.size(); i++) {
-      if (position_sets[i].contains(final_position)) {
-        DFA_final_states.insert(i);
+    for (DFA::state_type i = 0; i < position_sets.size(); i++) {
+      if (std::ranges::binary_search(*position_sets[i], final_position)) {
+        DFA_final_states.insert(DFA_final_states.end(), i);
       }
     }
 
-    return {DFA_states, alphabet, 0, DFA_transition_function, DFA_final_states};
+    return {std::move(DFA_states), alphabet, 0,
+            std::move(DFA_transition_function), std::move(DFA_final_states)};
   }
 } // namespace cyy::computation
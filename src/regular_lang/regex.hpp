@@ -17,6 +17,11 @@ namespace cyy::computation {
   class regex {
 
   public:
+    class syntax_node;
+    //! The positions of the symbol nodes, they are assigned for each use of a
+    //! tree so that a tree can be shared between threads and regexes.
+    using position_map_type =
+        std::unordered_map<const syntax_node *, uint64_t>;
     class syntax_node {
     public:
       virtual ~syntax_node() = default;
@@ -28,11 +33,15 @@ namespace cyy::computation {
       virtual bool is_epsilon_node() const = 0;
       virtual bool nullable() const = 0;
       virtual void assign_position(
-          std::unordered_map<uint64_t, symbol_type> &position_to_symbol) = 0;
-      virtual std::unordered_set<uint64_t> first_pos() const = 0;
-      virtual std::unordered_set<uint64_t> last_pos() const = 0;
+          position_map_type &positions,
+          std::unordered_map<uint64_t, symbol_type> &position_to_symbol)
+          const = 0;
+      virtual std::unordered_set<uint64_t>
+      first_pos(const position_map_type &positions) const = 0;
+      virtual std::unordered_set<uint64_t>
+      last_pos(const position_map_type &positions) const = 0;
       virtual std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-      follow_pos() const = 0;
+      follow_pos(const position_map_type &positions) const = 0;
       virtual std::shared_ptr<syntax_node> simplify() const = 0;
       virtual symbol_string to_string() const = 0;
     };
@@ -47,12 +56,15 @@ namespace cyy::computation {
       bool is_empty_set_node() const override { return true; }
       bool is_epsilon_node() const override { return false; }
       bool nullable() const noexcept override { return true; }
-      void assign_position(std::unordered_map<uint64_t, symbol_type>
-                               &position_to_symbol) override;
-      std::unordered_set<uint64_t> first_pos() const override;
-      std::unordered_set<uint64_t> last_pos() const override;
+      void assign_position(position_map_type &positions,
+                           std::unordered_map<uint64_t, symbol_type>
+                               &position_to_symbol) const override;
+      std::unordered_set<uint64_t>
+      first_pos(const position_map_type &positions) const override;
+      std::unordered_set<uint64_t>
+      last_pos(const position_map_type &positions) const override;
       std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-      follow_pos() const override {
+      follow_pos(const position_map_type & /*positions*/) const override {
         return {};
       }
       std::shared_ptr<syntax_node> simplify() const noexcept override {
@@ -71,12 +83,15 @@ namespace cyy::computation {
       bool nullable() const noexcept override { return true; }
       bool is_empty_set_node() const override { return false; }
       bool is_epsilon_node() const override { return true; }
-      void assign_position(std::unordered_map<uint64_t, symbol_type>
-                               &position_to_symbol) noexcept override;
-      std::unordered_set<uint64_t> first_pos() const override;
-      std::unordered_set<uint64_t> last_pos() const override;
+      void assign_position(position_map_type &positions,
+                           std::unordered_map<uint64_t, symbol_type>
+                               &position_to_symbol) const noexcept override;
+      std::unordered_set<uint64_t>
+      first_pos(const position_map_type &positions) const override;
+      std::unordered_set<uint64_t>
+      last_pos(const position_map_type &positions) const override;
       std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-      follow_pos() const override {
+      follow_pos(const position_map_type & /*positions*/) const override {
         return {};
       }
       std::shared_ptr<syntax_node> simplify() const override { return {}; }
@@ -93,12 +108,15 @@ namespace cyy::computation {
       bool is_empty_set_node() const override { return false; }
       bool is_epsilon_node() const override { return false; }
       bool nullable() const noexcept override { return false; }
-      void assign_position(std::unordered_map<uint64_t, symbol_type>
-                               &position_to_symbol) override;
-      std::unordered_set<uint64_t> first_pos() const override;
-      std::unordered_set<uint64_t> last_pos() const override;
+      void assign_position(position_map_type &positions,
+                           std::unordered_map<uint64_t, symbol_type>
+                               &position_to_symbol) const override;
+      std::unordered_set<uint64_t>
+      first_pos(const position_map_type &positions) const override;
+      std::unordered_set<uint64_t>
+      last_pos(const position_map_type &positions) const override;
       std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-      follow_pos() const override {
+      follow_pos(const position_map_type & /*positions*/) const override {
         return {};
       }
       std::shared_ptr<syntax_node> simplify() const override { return {}; }
@@ -106,7 +124,6 @@ namespace cyy::computation {
 
     private:
       symbol_type symbol;
-      uint64_t position{0};
     };
     class union_node final : public syntax_node {
     public:
@@ -127,12 +144,15 @@ namespace cyy::computation {
       bool nullable() const override {
         return left_node->nullable() || right_node->nullable();
       }
-      void assign_position(std::unordered_map<uint64_t, symbol_type>
-                               &position_to_symbol) override;
-      std::unordered_set<uint64_t> first_pos() const override;
-      std::unordered_set<uint64_t> last_pos() const override;
+      void assign_position(position_map_type &positions,
+                           std::unordered_map<uint64_t, symbol_type>
+                               &position_to_symbol) const override;
+      std::unordered_set<uint64_t>
+      first_pos(const position_map_type &positions) const override;
+      std::unordered_set<uint64_t>
+      last_pos(const position_map_type &positions) const override;
       std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-      follow_pos() const override;
+      follow_pos(const position_map_type &positions) const override;
       bool is_empty_set_node() const override;
       bool is_epsilon_node() const override;
       std::shared_ptr<syntax_node> simplify() const override;
@@ -181,12 +201,15 @@ namespace cyy::computation {
       bool nullable() const override {
         return left_node->nullable() && right_node->nullable();
       }
-      void assign_position(std::unordered_map<uint64_t, symbol_type>
-                               &position_to_symbol) override;
-      std::unordered_set<uint64_t> first_pos() const override;
-      std::unordered_set<uint64_t> last_pos() const override;
+      void assign_position(position_map_type &positions,
+                           std::unordered_map<uint64_t, symbol_type>
+                               &position_to_symbol) const override;
+      std::unordered_set<uint64_t>
+      first_pos(const position_map_type &positions) const override;
+      std::unordered_set<uint64_t>
+      last_pos(const position_map_type &positions) const override;
       std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-      follow_pos() const override;
+      follow_pos(const position_map_type &positions) const override;
       bool is_empty_set_node() const override;
       bool is_epsilon_node() const override;
       std::shared_ptr<syntax_node> simplify() const override;
@@ -212,10 +235,13 @@ namespace cyy::computation {
       CFG to_CFG(const ALPHABET_ptr &alphabet,
                  const CFG::nonterminal_type &start_symbol) const override;
       bool nullable() const noexcept override { return true; }
-      void assign_position(std::unordered_map<uint64_t, symbol_type>
-                               &position_to_symbol) override;
-      std::unordered_set<uint64_t> first_pos() const override;
-      std::unordered_set<uint64_t> last_pos() const override;
+      void assign_position(position_map_type &positions,
+                           std::unordered_map<uint64_t, symbol_type>
+                               &position_to_symbol) const override;
+      std::unordered_set<uint64_t>
+      first_pos(const position_map_type &positions) const override;
+      std::unordered_set<uint64_t>
+      last_pos(const position_map_type &positions) const override;
       bool is_empty_set_node() const override;
       bool is_epsilon_node() const override;
       std::shared_ptr<syntax_node> simplify() const override;
@@ -232,7 +258,7 @@ namespace cyy::computation {
     private:
       std::shared_ptr<syntax_node> inner_node;
       std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-      follow_pos() const override;
+      follow_pos(const position_map_type &positions) const override;
     };
 
     regex(ALPHABET_ptr alphabet_, symbol_string_view view)
@@ -264,6 +290,6 @@ namespace cyy::computation {
     const LL_grammar &get_grammar() const;
 
     ALPHABET_ptr alphabet;
-    mutable std::shared_ptr<regex::syntax_node> syntax_tree;
+    std::shared_ptr<regex::syntax_node> syntax_tree;
   };
 } // namespace cyy::computation
@@ -5,6 +5,8 @@
  * \date 2018-03-04
  */
 
+#include <mutex>
+
 #include <cyy/algorithm/alphabet/range_alphabet.hpp>
 
 #include "exception.hpp"
@@ -99,6 +101,8 @@ namespace cyy::computation {
 
   const LL_grammar &regex::get_grammar() const {
     static std::unordered_map<std::string, std::shared_ptr<LL_grammar>> factory;
+    static std::mutex factory_mutex;
+    std::lock_guard lock(factory_mutex);
     auto &regex_grammar = factory[alphabet->get_name()];
     if (regex_grammar) {
       return *regex_grammar;
@@ -196,6 +200,7 @@ namespace cyy::computation {
 
   std::shared_ptr<regex::syntax_node>
   regex::parse(symbol_string_view view) const {
+    instrumentation::add(instrumentation::counter::regex_parse);
 
     using syntax_node_ptr = std::shared_ptr<regex::syntax_node>;
 
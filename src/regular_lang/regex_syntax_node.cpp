@@ -28,20 +28,21 @@ namespace cyy::computation {
   }
 
   void regex::basic_node::assign_position(
-      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) {
-    if (position_to_symbol.empty()) {
-      position = 1;
-    } else {
-      position = std::ranges::max(std::views::keys(position_to_symbol)) + 1;
-    }
-    position_to_symbol.insert({position, symbol});
+      position_map_type &positions,
+      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) const {
+    // positions are numbered from 1 in tree order
+    auto const position = position_to_symbol.size() + 1;
+    positions.insert_or_assign(this, position);
+    position_to_symbol.emplace(position, symbol);
   }
 
-  std::unordered_set<uint64_t> regex::basic_node::first_pos() const {
-    return {position};
+  std::unordered_set<uint64_t>
+  regex::basic_node::first_pos(const position_map_type &positions) const {
+    return {positions.at(this)};
   }
-  std::unordered_set<uint64_t> regex::basic_node::last_pos() const {
-    return first_pos();
+  std::unordered_set<uint64_t>
+  regex::basic_node::last_pos(const position_map_type &positions) const {
+    return first_pos(positions);
   }
 
   NFA regex::epsilon_node::to_NFA(const ALPHABET_ptr &alphabet,
@@ -63,13 +64,16 @@ namespace cyy::computation {
   }
 
   void regex::epsilon_node::assign_position(
-      std::unordered_map<uint64_t, symbol_type> &position_to_symbol
-      [[maybe_unused]]) noexcept {}
+      position_map_type & /*positions*/,
+      std::unordered_map<uint64_t, symbol_type> & /*position_to_symbol*/)
+      const noexcept {}
 
-  std::unordered_set<uint64_t> regex::epsilon_node::first_pos() const {
+  std::unordered_set<uint64_t> regex::epsilon_node::first_pos(
+      const position_map_type & /*positions*/) const {
     return {};
   }
-  std::unordered_set<uint64_t> regex::epsilon_node::last_pos() const {
+  std::unordered_set<uint64_t> regex::epsilon_node::last_pos(
+      const position_map_type & /*positions*/) const {
     return {};
   }
 
@@ -84,14 +88,18 @@ namespace cyy::computation {
   }
 
   void regex::empty_set_node::assign_position(
-      std::unordered_map<uint64_t, symbol_type> & /*position_to_symbol*/) {
+      position_map_type & /*positions*/,
+      std::unordered_map<uint64_t, symbol_type> & /*position_to_symbol*/)
+      const {
     throw std::logic_error("unsupported");
   }
 
-  std::unordered_set<uint64_t> regex::empty_set_node::first_pos() const {
+  std::unordered_set<uint64_t> regex::empty_set_node::first_pos(
+      const position_map_type & /*positions*/) const {
     return {};
   }
-  std::unordered_set<uint64_t> regex::empty_set_node::last_pos() const {
+  std::unordered_set<uint64_t> regex::empty_set_node::last_pos(
+      const position_map_type & /*positions*/) const {
     return {};
   }
 
@@ -157,25 +165,28 @@ namespace cyy::computation {
   }
 
   void regex::union_node::assign_position(
-      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) {
-    left_node->assign_position(position_to_symbol);
-    right_node->assign_position(position_to_symbol);
+      position_map_type &positions,
+      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) const {
+    left_node->assign_position(positions, position_to_symbol);
+    right_node->assign_position(positions, position_to_symbol);
   }
 
-  std::unordered_set<uint64_t> regex::union_node::first_pos() const {
-    auto tmp = left_node->first_pos();
-    tmp.merge(right_node->first_pos());
+  std::unordered_set<uint64_t>
+  regex::union_node::first_pos(const position_map_type &positions) const {
+    auto tmp = left_node->first_pos(positions);
+    tmp.merge(right_node->first_pos(positions));
     return tmp;
   }
-  std::unordered_set<uint64_t> regex::union_node::last_pos() const {
-    auto tmp = left_node->last_pos();
-    tmp.merge(right_node->last_pos());
+  std::unordered_set<uint64_t>
+  regex::union_node::last_pos(const position_map_type &positions) const {
+    auto tmp = left_node->last_pos(positions);
+    tmp.merge(right_node->last_pos(positions));
     return tmp;
   }
   std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-  regex::union_node::follow_pos() const {
-    auto res = left_node->follow_pos();
-    res.merge(right_node->follow_pos());
+  regex::union_node::follow_pos(const position_map_type &positions) const {
+    auto res = left_node->follow_pos(positions);
+    res.merge(right_node->follow_pos(positions));
     return res;
   }
   std::shared_ptr<regex::syntax_node> regex::union_node::simplify() const {
@@ -236,39 +247,42 @@ namespace cyy::computation {
   }
 
   void regex::concat_node::assign_position(
-      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) {
-    left_node->assign_position(position_to_symbol);
-    right_node->assign_position(position_to_symbol);
+      position_map_type &positions,
+      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) const {
+    left_node->assign_position(positions, position_to_symbol);
+    right_node->assign_position(positions, position_to_symbol);
   }
 
-  std::unordered_set<uint64_t> regex::concat_node::first_pos() const {
+  std::unordered_set<uint64_t>
+  regex::concat_node::first_pos(const position_map_type &positions) const {
     if (!left_node->nullable()) {
-      return left_node->first_pos();
+      return left_node->first_pos(positions);
     }
-    auto tmp = left_node->first_pos();
-    tmp.merge(right_node->first_pos());
+    auto tmp = left_node->first_pos(positions);
+    tmp.merge(right_node->first_pos(positions));
     return tmp;
   }
 
-  std::unordered_set<uint64_t> regex::concat_node::last_pos() const {
+  std::unordered_set<uint64_t>
+  regex::concat_node::last_pos(const position_map_type &positions) const {
     if (!right_node->nullable()) {
-      return right_node->last_pos();
+      return right_node->last_pos(positions);
     }
-    auto tmp = left_node->last_pos();
-    tmp.merge(right_node->last_pos());
+    auto tmp = left_node->last_pos(positions);
+    tmp.merge(right_node->last_pos(positions));
     return tmp;
   }
 
   std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-  regex::concat_node::follow_pos() const {
-    auto res = left_node->follow_pos();
-    res.merge(right_node->follow_pos());
+  regex::concat_node::follow_pos(const position_map_type &positions) const {
+    auto res = left_node->follow_pos(positions);
+    res.merge(right_node->follow_pos(positions));
 
-    auto tmp = right_node->first_pos();
+    auto tmp = right_node->first_pos(positions);
     if (tmp.empty()) {
       return res;
     }
-    for (auto pos : left_node->last_pos()) {
+    for (auto pos : left_node->last_pos(positions)) {
       res[pos].merge(decltype(tmp)(tmp));
     }
     return res;
@@ -339,25 +353,31 @@ namespace cyy::computation {
   }
 
   void regex::kleene_closure_node::assign_position(
-      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) {
-    inner_node->assign_position(position_to_symbol);
+      position_map_type &positions,
+      std::unordered_map<uint64_t, symbol_type> &position_to_symbol) const {
+    inner_node->assign_position(positions, position_to_symbol);
   }
 
-  std::unordered_set<uint64_t> regex::kleene_closure_node::first_pos() const {
-    return inner_node->first_pos();
+  std::unordered_set<uint64_t>
+  regex::kleene_closure_node::first_pos(
+      const position_map_type &positions) const {
+    return inner_node->first_pos(positions);
   }
-  std::unordered_set<uint64_t> regex::kleene_closure_node::last_pos() const {
-    return inner_node->last_pos();
+  std::unordered_set<uint64_t>
+  regex::kleene_closure_node::last_pos(
+      const position_map_type &positions) const {
+    return inner_node->last_pos(positions);
   }
 
   std::unordered_map<uint64_t, std::unordered_set<uint64_t>>
-  regex::kleene_closure_node::follow_pos() const {
-    auto res = inner_node->follow_pos();
-    auto tmp = inner_node->first_pos();
+  regex::kleene_closure_node::follow_pos(
+      const position_map_type &positions) const {
+    auto res = inner_node->follow_pos(positions);
+    auto tmp = inner_node->first_pos(positions);
     if (tmp.empty()) {
       return res;
     }
-    for (auto pos : inner_node->last_pos()) {
+    for (auto pos : inner_node->last_pos(positions)) {
       res[pos].merge(decltype(tmp)(tmp));
     }
     return res;
@@ -75,6 +75,49 @@ TEST_CASE("get_terminals") {
   CHECK(cfg.get_terminals() == CFG::terminal_set_type{'+', '*', ')', '(', id});
 }
 
+TEST_CASE("interned_grammar") {
+  CFG::production_set_type productions;
+  productions["S"] = {{'a', "S", 'b'}, {"T"}};
+  productions["T"] = {{'c'}, {}};
+  CFG cfg("common_tokens", "S", productions);
+
+  auto const &grammar = cfg.get_interned_grammar();
+  CHECK_EQ(grammar.get_name(interned_grammar::start_symbol), "S");
+  REQUIRE_EQ(grammar.get_nonterminal_number(), 2);
+  auto const T = grammar.get_id("T");
+  REQUIRE(T.has_value());
+  CHECK_EQ(grammar.get_name(*T), "T");
+  CHECK(!grammar.get_id("U").has_value());
+  CHECK_EQ(grammar.get_production_number(), 4);
+  for (auto const head : {interned_grammar::start_symbol, *T}) {
+    CHECK_EQ(std::ranges::distance(grammar.get_production_indices(head)), 2);
+    for (auto const index : grammar.get_production_indices(head)) {
+      auto const &production = grammar.get_production(index);
+      auto const &original = grammar.get_original_production(index);
+      CHECK_EQ(production.head, head);
+      CHECK_EQ(original.get_head(), grammar.get_name(head));
+      REQUIRE_EQ(production.body.size(), original.get_body().size());
+      for (size_t i = 0; i < production.body.size(); i++) {
+        if (production.body[i].is_terminal()) {
+          CHECK_EQ(original.get_body()[i], production.body[i].get_terminal());
+        } else {
+          CHECK_EQ(original.get_body()[i],
+                   grammar.get_name(production.body[i].get_nonterminal()));
+        }
+      }
+    }
+  }
+
+  // mutation rebuilds the interned grammar
+  cfg.eliminate_epsilon_productions();
+  size_t production_number = 0;
+  for (auto const &[_, bodies] : cfg.get_productions()) {
+    production_number += bodies.size();
+  }
+  CHECK_EQ(cfg.get_interned_grammar().get_production_number(),
+           production_number);
+}
+
 TEST_CASE("eliminate_left_recursion") {
   CFG::production_set_type productions;
   productions["S"] = {
@@ -132,19 +175,43 @@ TEST_CASE("left_factoring") {
   CHECK_EQ(cfg, CFG("common_tokens", "S", reduced_productions));
 }
 
-// TEST_CASE("recursive_descent_parse") {
-//   CFG::production_set_type productions;
-//   productions["S"] = {
-//       {'a', "S", 'a'},
-//       {'a', 'a'},
-//   };
-//
-//   CFG cfg("common_tokens", "S", productions);
-//   auto terminals = U"aaaa";
-//   CHECK(cfg.recursive_descent_parse(terminals));
-//   terminals = U"aaaaaa";
-//   CHECK(cfg.recursive_descent_parse(terminals));
-// }
+TEST_CASE("recursive_descent_parse") {
+  SUBCASE("backtracking") {
+    CFG::production_set_type productions;
+    productions["S"] = {
+        {'a', "S", 'a'},
+        {'a', 'a'},
+    };
+
+    CFG cfg("common_tokens", "S", productions);
+    auto terminals = U"aaaa";
+    CHECK(cfg.recursive_descent_parse(terminals));
+    terminals = U"aaaaaa";
+    CHECK(cfg.recursive_descent_parse(terminals));
+    terminals = U"aaaaa";
+    CHECK(!cfg.recursive_descent_parse(terminals));
+  }
+  SUBCASE("left recursion") {
+    CFG::production_set_type productions;
+    auto id = static_cast<CFG::terminal_type>(cyy::algorithm::common_token::id);
+    productions["E"] = {{"E", '+', "T"}, {"T"}};
+    productions["T"] = {{"T", '*', "F"}, {"F"}};
+    productions["F"] = {{'(', "E", ')'}, {id}};
+    CFG cfg("common_tokens", "E", productions);
+    CHECK(cfg.recursive_descent_parse(
+        symbol_string{id, '+', id, '*', '(', id, '+', id, ')'}));
+    CHECK(!cfg.recursive_descent_parse(symbol_string{id, '+', '*', id}));
+    CHECK(!cfg.recursive_descent_parse(symbol_string{}));
+  }
+  SUBCASE("nullable cycle") {
+    CFG::production_set_type productions;
+    productions["S"] = {{"S", "S"}, {'a'}, {}};
+    CFG cfg("common_tokens", "S", productions);
+    CHECK(cfg.recursive_descent_parse(U""));
+    CHECK(cfg.recursive_descent_parse(U"aaa"));
+    CHECK(!cfg.recursive_descent_parse(U"ab"));
+  }
+}
 
 TEST_CASE("first_and_follow") {
   CFG::production_set_type productions;
@@ -186,6 +253,42 @@ TEST_CASE("first_and_follow") {
   CHECK(follow_sets["F"] == CFG::terminal_set_type{'+', '*', ')', endmarker});
 }
 
+TEST_CASE("grammar_analysis") {
+  CFG::production_set_type productions;
+  productions["S"] = {{"A", "B", 'c'}, {"B", "A"}};
+  productions["A"] = {{'a', "A"}, {}};
+  productions["B"] = {{"A"}, {'b'}};
+  CFG cfg("common_tokens", "S", productions);
+
+  CHECK_EQ(cfg.nullable(), CFG::nonterminal_set_type{"S", "A", "B"});
+  auto const &grammar = cfg.get_interned_grammar();
+  auto const &grammar_sets = cfg.get_grammar_analysis();
+  auto const to_set = [&](auto const &bitset) {
+    return grammar_sets.to_terminal_set(bitset);
+  };
+  auto const S = interned_grammar::start_symbol;
+  auto const A = *grammar.get_id("A");
+  auto const B = *grammar.get_id("B");
+  CHECK_EQ(to_set(grammar_sets.get_first(S)),
+           CFG::terminal_set_type{'a', 'b', 'c'});
+  CHECK_EQ(to_set(grammar_sets.get_first(B)), CFG::terminal_set_type{'a', 'b'});
+  CHECK_EQ(to_set(grammar_sets.get_follow(A)),
+           CFG::terminal_set_type{'a', 'b', 'c', ALPHABET::endmarker});
+  CHECK_EQ(to_set(grammar_sets.get_follow(B)),
+           CFG::terminal_set_type{'a', 'c', ALPHABET::endmarker});
+
+  for (auto const index : grammar.get_production_indices(S)) {
+    auto const &body = grammar.get_original_production(index).get_body();
+    for (size_t pos = 0; pos <= body.size(); pos++) {
+      auto const &suffix_first = grammar_sets.get_body_suffix_first(index, pos);
+      auto const [first_set, nullable] =
+          cfg.first(grammar_symbol_const_span_type(body).subspan(pos));
+      CHECK_EQ(to_set(suffix_first.terminals), first_set);
+      CHECK_EQ(suffix_first.nullable, nullable);
+    }
+  }
+}
+
 TEST_CASE("to_PDA") {
   CFG::production_set_type productions;
   productions["S"] = {{'a', "T", 'b'}, {'c', 'd'}, {'b'}};
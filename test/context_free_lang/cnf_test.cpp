@@ -70,4 +70,27 @@ TEST_CASE("to_CNF") {
     str = U"aa";
     CHECK(!cnf.parse(str));
   }
+  SUBCASE("parse long string") {
+    CHECK(cnf.parse(U""));
+    std::u32string str;
+    for (size_t i = 0; i < 100; i++) {
+      str += (i % 3 == 0) ? U"abba" : U"ab";
+    }
+    CHECK(cnf.parse(str));
+    str.push_back('a');
+    CHECK(!cnf.parse(str));
+    str.push_back('b');
+    CHECK(cnf.parse(str));
+  }
+  SUBCASE("parallel parse") {
+    std::u32string str;
+    for (size_t i = 0; i < 50; i++) {
+      str += (i % 3 == 0) ? U"abba" : U"ba";
+    }
+    for (size_t const grain_size : {1, 4, 64}) {
+      CHECK(cnf.parallel_parse(str, 4, grain_size));
+      CHECK(!cnf.parallel_parse(str + U"a", 4, grain_size));
+      CHECK(!cnf.parallel_parse(U"aab", 4, grain_size));
+    }
+  }
 }
@@ -23,6 +23,13 @@ TEST_CASE("DCFG") {
     auto parse_tree = dcfg.get_parse_tree(U"()");
     CHECK(parse_tree);
     std::cout << parse_tree->MMA_draw(dcfg.get_alphabet()) << std::endl;
+    // building the parsing table resets the caches of the grammar
+    for (auto const &[_, item_set] :
+         dcfg.get_dk().get_LR_0_item_set_collection()) {
+      for (auto const &item : item_set.get_kernel_items()) {
+        CHECK_EQ(item.get_head(), "S");
+      }
+    }
   }
   SUBCASE("DPDA") {
     auto endmarker = ALPHABET::endmarker;
@@ -2,13 +2,15 @@
  * \file dk_test.cpp
  */
 
+#include <algorithm>
+#include <iostream>
+#include <optional>
+
 #include <doctest/doctest.h>
 
 #include "alphabet/alphabet.hpp"
 #include "context_free_lang/dk.hpp"
 
-#include <iostream>
-
 using namespace cyy::computation;
 TEST_CASE("DK") {
   auto endmarker = ALPHABET::endmarker;
@@ -24,4 +26,89 @@ TEST_CASE("DK") {
   CFG cfg(ALPHABET::get("parentheses", true), "S", productions);
   auto dk = DK_DFA(cfg);
   std::cout << dk.MMA_draw(cfg) << std::endl;
+
+  // six item sets and the dead state
+  auto const &collection = dk.get_LR_0_item_set_collection();
+  CHECK_EQ(collection.size(), 7);
+  CHECK_EQ(std::ranges::count_if(
+               collection, [](auto const &p) { return p.second.empty(); }),
+           1);
+  CHECK_EQ(dk.get_dfa().get_final_states().size(), 4);
+  auto const &start_item_set = dk.get_LR_0_item_set(0);
+  CHECK(start_item_set.get_nonkernel_items().contains("S"));
+  CHECK(start_item_set.get_nonkernel_items().contains("T"));
+  auto goto_table = dk.get_goto_table();
+  auto const &item_set =
+      dk.get_LR_0_item_set(goto_table.at({0, CFG::nonterminal_type("T")}));
+  CHECK_EQ(item_set.get_kernel_items().size(), 2);
+  CHECK(item_set.get_nonkernel_items().empty());
+}
+
+TEST_CASE("DK outlives its CFG") {
+  std::optional<DK_DFA> dk;
+  {
+    CFG::production_set_type productions;
+    productions["S"] = {
+        {"T", ALPHABET::endmarker},
+    };
+    productions["T"] = {
+        {"T", '(', "T", ')'},
+        {},
+    };
+    CFG cfg(ALPHABET::get("parentheses", true), "S", productions);
+    dk.emplace(cfg);
+  }
+  auto const &item_set = dk->get_LR_0_item_set(
+      dk->get_goto_table().at({0, CFG::nonterminal_type("T")}));
+  REQUIRE_EQ(item_set.get_kernel_items().size(), 2);
+  for (auto const &item : item_set.get_kernel_items()) {
+    CHECK_EQ(item.get_head(), "T");
+    CHECK_EQ(item.get_dot_pos(), 1);
+  }
+}
+
+TEST_CASE("LR_0_item_set") {
+  CFG::production_set_type productions;
+  productions["T"] = {
+      {"T", '(', "T", ')'},
+      {'(', "T", ')'},
+      {},
+  };
+  CFG const cfg(ALPHABET::get("parentheses", true), "T", productions);
+  auto const grammar_ptr = cfg.get_shared_interned_grammar();
+  auto const &grammar = *grammar_ptr;
+  auto find_production = [&grammar](size_t body_size) {
+    for (size_t index = 0; index < grammar.get_production_number(); index++) {
+      if (grammar.get_production(index).body.size() == body_size) {
+        return index;
+      }
+    }
+    return grammar.get_production_number();
+  };
+  auto const production1 = find_production(4);
+  auto const production2 = find_production(3);
+  REQUIRE_LT(production1, grammar.get_production_number());
+  REQUIRE_LT(production2, grammar.get_production_number());
+
+  LR_0_item const item1(grammar_ptr, production1, 1);
+  LR_0_item const item2(grammar_ptr, production1, 3);
+  LR_0_item const item3(grammar_ptr, production2, 1);
+  CHECK_EQ(item1, LR_0_item(grammar_ptr, production1, 1));
+  CHECK_EQ(item1.get_production_index(), item2.get_production_index());
+  CHECK_NE(item1, item3);
+
+  LR_0_item_set set1;
+  set1.add_item(item1);
+  set1.add_item(item2);
+  set1.add_nonkernel_item("T");
+  LR_0_item_set set2;
+  set2.add_nonkernel_item("T");
+  set2.add_item(item2);
+  set2.add_item(item1);
+  set2.add_item(item1);
+  CHECK_EQ(set1, set2);
+  CHECK_EQ(std::hash<LR_0_item_set>()(set1),
+           std::hash<LR_0_item_set>()(set2));
+  set2.add_item(item3);
+  CHECK_NE(set1, set2);
 }
@@ -0,0 +1,72 @@
+/*!
+ * \file earley_parser_test.cpp
+ *
+ * \brief 测试Earley parser
+ */
+#include <doctest/doctest.h>
+
+#include "alphabet/common_tokens.hpp"
+#include "context_free_lang/earley_parser.hpp"
+
+using namespace cyy::computation;
+
+TEST_CASE("Earley parse") {
+  auto id = static_cast<CFG::terminal_type>(cyy::algorithm::common_token::id);
+  SUBCASE("ambiguous left recursive grammar") {
+    CFG::production_set_type productions;
+    productions["E"] = {
+        {"E", U'+', "E"},
+        {"E", U'*', "E"},
+        {U'(', "E", U')'},
+        {id},
+    };
+    Earley_parser parser(CFG("common_tokens", "E", productions));
+    CHECK(parser.recognize(symbol_string{id, U'+', id, U'*', id}));
+    CHECK(parser.recognize(symbol_string{U'(', id, U'+', id, U')', U'*', id}));
+    CHECK(!parser.recognize(symbol_string{id, U'+'}));
+    CHECK(!parser.recognize(symbol_string{}));
+
+    auto parse_tree = parser.get_parse_tree(symbol_string{id, U'+', id});
+    REQUIRE(parse_tree);
+    CHECK_EQ(parse_tree->grammar_symbol.get_nonterminal(), "E");
+    CHECK_EQ(parse_tree->children.size(), 3);
+    CHECK(!parser.get_parse_tree(symbol_string{id, id}));
+  }
+  SUBCASE("right recursion") {
+    CFG::production_set_type productions;
+    productions["S"] = {{U'a', "S"}, {U'b'}};
+    Earley_parser parser(CFG("common_tokens", "S", productions));
+    symbol_string str(1000, U'a');
+    str.push_back(U'b');
+    CHECK(parser.recognize(str));
+    auto parse_tree = parser.get_parse_tree(str);
+    REQUIRE(parse_tree);
+    CHECK_EQ(parse_tree->children.size(), 2);
+    str.push_back(U'b');
+    CHECK(!parser.recognize(str));
+  }
+  SUBCASE("nullable nonterminals") {
+    CFG::production_set_type productions;
+    productions["S"] = {{"A", "A", "A", "A"}};
+    productions["A"] = {{U'a'}, {"E"}};
+    productions["E"] = {{}};
+    Earley_parser parser(CFG("common_tokens", "S", productions));
+    CHECK(parser.recognize(symbol_string{}));
+    CHECK(parser.recognize(symbol_string{U'a'}));
+    CHECK(parser.recognize(symbol_string(4, U'a')));
+    CHECK(!parser.recognize(symbol_string(5, U'a')));
+    auto parse_tree = parser.get_parse_tree(symbol_string(2, U'a'));
+    REQUIRE(parse_tree);
+    CHECK_EQ(parse_tree->children.size(), 4);
+  }
+  SUBCASE("cyclic grammar") {
+    CFG::production_set_type productions;
+    productions["S"] = {{"T"}, {U'a'}};
+    productions["T"] = {{"S"}};
+    Earley_parser parser(CFG("common_tokens", "S", productions));
+    CHECK(parser.recognize(symbol_string{U'a'}));
+    auto parse_tree = parser.get_parse_tree(symbol_string{U'a'});
+    REQUIRE(parse_tree);
+    CHECK(!parser.recognize(symbol_string{U'a', U'a'}));
+  }
+}
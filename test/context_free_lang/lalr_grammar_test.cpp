@@ -8,6 +8,8 @@
 #include "alphabet/common_tokens.hpp"
 #include "context_free_lang/lalr_grammar.hpp"
 
+#include <unordered_map>
+
 using namespace cyy::computation;
 
 TEST_CASE("LALR(1) parse") {
@@ -33,3 +35,93 @@ TEST_CASE("LALR(1) parse") {
     CHECK_EQ(parse_tree->grammar_symbol.get_nonterminal(), "S");
   }
 }
+
+TEST_CASE("LALR(1) collection") {
+  auto id = static_cast<CFG::terminal_type>(cyy::algorithm::common_token::id);
+  CFG::production_set_type productions;
+  productions["S"] = {{"L", U'=', "R"}, {"R"}, {"A", "S", U'b'}};
+  productions["L"] = {{U'*', "R"}, {id}};
+  productions["R"] = {{"L"}, {"A", "R", "A"}};
+  productions["A"] = {{}, {U'a'}};
+  LALR_grammar grammar("common_tokens", "S", productions);
+
+  // the lookaheads of every LR(0) item and nonkernel head of a state
+  using lookahead_map_type =
+      std::unordered_map<LR_0_item, CFG::terminal_set_type>;
+  auto get_lookaheads = [](const LR_1_item_set &set) {
+    lookahead_map_type lookaheads;
+    for (auto const &item : set.get_kernel_items()) {
+      lookaheads[item].insert(item.get_lookahead_symbols().begin(),
+                              item.get_lookahead_symbols().end());
+    }
+    return std::pair{lookaheads, set.get_nonkernel_items()};
+  };
+
+  // the canonical LR(1) states merged by their LR(0) cores
+  auto [canonical_collection, _] =
+      grammar.canonical_LR_grammar::get_collection(grammar);
+  std::unordered_map<LR_0_item_set, LR_1_item_set> merged_sets;
+  for (auto &[state, set] : canonical_collection) {
+    if (!set.empty()) {
+      merged_sets[set.get_lr_0_item_set()].merge_lookahead_symbols(set);
+    }
+  }
+  auto [collection, goto_table] = grammar.get_collection();
+  size_t state_number = 0;
+  for (auto const &[state, set] : collection) {
+    if (set.empty()) {
+      continue;
+    }
+    state_number++;
+    auto it = merged_sets.find(set.get_lr_0_item_set());
+    REQUIRE(it != merged_sets.end());
+    CHECK(get_lookaheads(set) == get_lookaheads(it->second));
+  }
+  CHECK_EQ(state_number, merged_sets.size());
+}
+
+TEST_CASE("GLR parse") {
+  auto id = static_cast<CFG::terminal_type>(cyy::algorithm::common_token::id);
+  SUBCASE("ambiguous grammar") {
+    CFG::production_set_type productions;
+    productions["E"] = {
+        {"E", U'+', "E"},
+        {"E", U'*', "E"},
+        {id},
+    };
+    LALR_grammar grammar("common_tokens", "E", productions);
+    auto parse_tree =
+        grammar.get_GLR_parse_tree(symbol_string{id, U'+', id, U'*', id});
+    REQUIRE(parse_tree);
+    CHECK_EQ(parse_tree->grammar_symbol.get_nonterminal(), "E");
+    CHECK_EQ(parse_tree->children.size(), 3);
+    CHECK(grammar.GLR_parse(symbol_string{id}));
+    CHECK(!grammar.GLR_parse(symbol_string{id, U'+'}));
+    CHECK(!grammar.GLR_parse(symbol_string{id, id}));
+    CHECK_THROWS(static_cast<void>(grammar.parse(
+        symbol_string{id}, [](auto) {}, [](auto const &) {})));
+  }
+  SUBCASE("hidden left recursion") {
+    CFG::production_set_type productions;
+    productions["S"] = {{"A", "S", U'b'}, {U'x'}};
+    productions["A"] = {{}};
+    canonical_LR_grammar grammar("common_tokens", "S", productions);
+    CHECK(grammar.GLR_parse(symbol_string{U'x'}));
+    CHECK(grammar.GLR_parse(symbol_string{U'x', U'b', U'b'}));
+    CHECK(!grammar.GLR_parse(symbol_string{U'b', U'x'}));
+  }
+  SUBCASE("deterministic grammar") {
+    CFG::production_set_type productions;
+    productions["S"] = {{"L", U'=', "R"}, {"R"}};
+    productions["L"] = {{U'*', "R"}, {id}};
+    productions["R"] = {{"L"}};
+    LALR_grammar grammar("common_tokens", "S", productions);
+    symbol_string const str{U'*', id, U'=', U'*', U'*', id};
+    auto parse_tree = grammar.get_GLR_parse_tree(str);
+    REQUIRE(parse_tree);
+    auto LR_parse_tree = grammar.get_parse_tree(str);
+    REQUIRE(LR_parse_tree);
+    CHECK_EQ(parse_tree->MMA_draw(grammar.get_alphabet()),
+             LR_parse_tree->MMA_draw(grammar.get_alphabet()));
+  }
+}
@@ -0,0 +1,75 @@
+/*!
+ * \file minimal_lr_grammar_test.cpp
+ *
+ * \brief 测试minimal LR(1) grammar
+ */
+#include <doctest/doctest.h>
+
+#include "alphabet/common_tokens.hpp"
+#include "context_free_lang/lalr_grammar.hpp"
+#include "context_free_lang/minimal_lr_grammar.hpp"
+
+using namespace cyy::computation;
+
+namespace {
+  size_t get_state_number(const LR_1_grammar &grammar) {
+    size_t state_number = 0;
+    for (auto const &[_, set] : grammar.get_collection().first) {
+      if (!set.empty()) {
+        state_number++;
+      }
+    }
+    return state_number;
+  }
+} // namespace
+
+TEST_CASE("minimal LR(1) parse") {
+  SUBCASE("LR(1) grammar with LALR(1) conflicts") {
+    CFG::production_set_type productions;
+    productions["S"] = {
+        {U'a', "A", U'd'},
+        {U'b', "B", U'd'},
+        {U'a', "B", U'e'},
+        {U'b', "A", U'e'},
+    };
+    productions["A"] = {{U'c'}};
+    productions["B"] = {{U'c'}};
+
+    LALR_grammar lalr_grammar("common_tokens", "S", productions);
+    CHECK_THROWS(static_cast<void>(lalr_grammar.parse(
+        symbol_string{U'a', U'c', U'd'}, [](auto) {}, [](auto const &) {})));
+
+    minimal_LR_grammar grammar("common_tokens", "S", productions);
+    for (auto const &str :
+         {symbol_string{U'a', U'c', U'd'}, symbol_string{U'b', U'c', U'd'},
+          symbol_string{U'a', U'c', U'e'}, symbol_string{U'b', U'c', U'e'}}) {
+      auto parse_tree = grammar.get_parse_tree(str);
+      REQUIRE(parse_tree);
+      CHECK_EQ(parse_tree->children.size(), 3);
+    }
+    CHECK(!grammar.get_parse_tree(symbol_string{U'a', U'c'}));
+    CHECK(!grammar.get_parse_tree(symbol_string{U'c', U'd'}));
+
+    canonical_LR_grammar canonical_grammar("common_tokens", "S", productions);
+    CHECK_EQ(get_state_number(grammar), get_state_number(canonical_grammar));
+  }
+
+  SUBCASE("LALR(1) grammar") {
+    CFG::production_set_type productions;
+    auto id = static_cast<CFG::terminal_type>(cyy::algorithm::common_token::id);
+    productions["S"] = {{"L", U'=', "R"}, {"R"}};
+    productions["L"] = {{U'*', "R"}, {id}};
+    productions["R"] = {{"L"}};
+
+    minimal_LR_grammar grammar("common_tokens", "S", productions);
+    auto parse_tree =
+        grammar.get_parse_tree(symbol_string{U'*', id, U'=', U'*', U'*', id});
+    REQUIRE(parse_tree);
+    CHECK_EQ(parse_tree->grammar_symbol.get_nonterminal(), "S");
+
+    LALR_grammar lalr_grammar("common_tokens", "S", productions);
+    CHECK_EQ(get_state_number(grammar), get_state_number(lalr_grammar));
+    canonical_LR_grammar canonical_grammar("common_tokens", "S", productions);
+    CHECK_LT(get_state_number(grammar), get_state_number(canonical_grammar));
+  }
+}
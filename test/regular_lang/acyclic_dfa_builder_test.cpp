@@ -0,0 +1,76 @@
+/*!
+ * \file acyclic_dfa_builder_test.cpp
+ *
+ * \brief
+ */
+#include <doctest/doctest.h>
+
+#include "regular_lang/acyclic_dfa_builder.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+namespace {
+  DFA get_minimal_DFA(const std::vector<symbol_string> &strings) {
+    symbol_string expr = U"(";
+    for (auto const &str : strings) {
+      if (expr.size() > 1) {
+        expr.push_back('|');
+      }
+      expr += str;
+    }
+    expr.push_back(')');
+    return regex("ab_set", expr).to_DFA().minimize().first;
+  }
+} // namespace
+
+TEST_CASE("acyclic DFA builder") {
+  auto const alphabet = ALPHABET::get("ab_set");
+  std::vector<symbol_string> strings{U"bab", U"a",   U"abba", U"bb",
+                                     U"ab",  U"aab", U"bbab", U"babb"};
+
+  acyclic_DFA_builder builder(alphabet);
+  for (auto const &str : strings) {
+    CHECK(builder.add(str));
+  }
+  CHECK(!builder.add(U"ab"));
+  CHECK_EQ(builder.get_string_number(), strings.size());
+
+  auto const expected_dfa = get_minimal_DFA(strings);
+  auto const dfa = builder.to_DFA();
+  CHECK(dfa.language_equivalent_with(expected_dfa));
+  CHECK_EQ(dfa.get_states().size(), expected_dfa.get_states().size());
+
+  SUBCASE("sorted") {
+    auto sorted_strings = strings;
+    std::ranges::sort(sorted_strings);
+    auto const sorted_builder =
+        acyclic_DFA_builder::from_sorted(alphabet, sorted_strings);
+    CHECK_EQ(sorted_builder.get_state_number(), builder.get_state_number());
+    CHECK(sorted_builder.to_DFA().language_equivalent_with(dfa));
+    CHECK_THROWS_AS(
+        acyclic_DFA_builder::from_sorted(alphabet, std::vector<symbol_string>{
+                                                       U"b", U"a"}),
+        exception::unsorted_strings);
+  }
+
+  SUBCASE("remove") {
+    CHECK(builder.remove(U"bb"));
+    CHECK(builder.remove(U"abba"));
+    CHECK(!builder.remove(U"abba"));
+    CHECK(!builder.contains(U"bb"));
+    CHECK(builder.contains(U"bbab"));
+    std::vector<symbol_string> remaining_strings{U"bab", U"a",    U"ab",
+                                                 U"aab", U"bbab", U"babb"};
+    auto const remaining_dfa = get_minimal_DFA(remaining_strings);
+    CHECK(builder.to_DFA().language_equivalent_with(remaining_dfa));
+    CHECK_EQ(builder.to_DFA().get_states().size(),
+             remaining_dfa.get_states().size());
+
+    acyclic_DFA_builder rebuilt_builder(alphabet);
+    for (auto const &str : remaining_strings) {
+      rebuilt_builder.add(str);
+    }
+    CHECK_EQ(builder.get_state_number(), rebuilt_builder.get_state_number());
+  }
+}
@@ -0,0 +1,48 @@
+/*!
+ * \file binary_format_test.cpp
+ *
+ * \brief 测试automaton的二进制格式
+ */
+#include <doctest/doctest.h>
+
+#include "regular_lang/binary_format.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+TEST_CASE("binary format round trip") {
+  regex reg("ab_set", U"(a|b)*abb");
+  auto path = std::filesystem::temp_directory_path() / "binary_format_test.bin";
+
+  SUBCASE("DFA") {
+    auto dfa = reg.to_DFA();
+    save_binary(dfa, path);
+    mapped_DFA const mapped_dfa(path);
+    CHECK_EQ(mapped_dfa.get_alphabet_name(), "ab_set");
+    CHECK_EQ(mapped_dfa.get_state_number(), dfa.get_states().size());
+    for (auto const *str : {U"", U"abb", U"aabb", U"babb", U"bab", U"abc"}) {
+      CHECK_EQ(mapped_dfa.recognize(str), dfa.recognize(str));
+    }
+    CHECK(mapped_dfa.to_DFA().language_equivalent_with(dfa));
+    CHECK_THROWS_AS(load_NFA_binary(path),
+                    const exception::invalid_automaton_binary &);
+  }
+
+  SUBCASE("NFA") {
+    auto nfa = reg.to_NFA();
+    save_binary(nfa, path);
+    auto loaded_nfa = load_NFA_binary(path);
+    CHECK_EQ(loaded_nfa.get_states().size(), nfa.get_states().size());
+    for (auto const *str : {U"", U"abb", U"aabb", U"babb", U"bab"}) {
+      CHECK_EQ(loaded_nfa.recognize(str), nfa.recognize(str));
+    }
+    CHECK_THROWS_AS(mapped_DFA{path},
+                    const exception::invalid_automaton_binary &);
+  }
+
+  SUBCASE("unwritable path") {
+    CHECK_THROWS_AS(save_binary(reg.to_DFA(), path / "no_such_dir" / "a.bin"),
+                    const exception::invalid_automaton_binary &);
+  }
+  std::filesystem::remove(path);
+}
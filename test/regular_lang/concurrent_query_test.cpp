@@ -0,0 +1,104 @@
+/*!
+ * \file concurrent_query_test.cpp
+ *
+ * \brief const queries on shared automata from multiple threads
+ */
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+#include "context_free_lang/lalr_grammar.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+namespace {
+  template <typename F> void run_concurrently(F &&fun) {
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < 8; i++) {
+      threads.emplace_back(fun);
+    }
+  }
+} // namespace
+
+TEST_CASE("concurrent query") {
+  symbol_string const expr = U"(a|b)*abb(a|b)?";
+  std::vector<symbol_string> const inputs{U"abb", U"aabba", U"ab",
+                                          U"babbb", U""};
+
+  SUBCASE("NFA") {
+    auto const nfa = regex("ab_set", expr).to_NFA();
+    std::vector<bool> expected;
+    {
+      auto const nfa_copy = nfa;
+      for (auto const &input : inputs) {
+        expected.push_back(nfa_copy.recognize(input));
+      }
+    }
+    std::atomic_size_t mismatch_count{0};
+    run_concurrently([&] {
+      for (size_t round = 0; round < 100; round++) {
+        for (size_t i = 0; i < inputs.size(); i++) {
+          if (nfa.recognize(inputs[i]) != expected[i]) {
+            mismatch_count++;
+          }
+        }
+      }
+    });
+    CHECK(mismatch_count == 0);
+  }
+
+  SUBCASE("DFA") {
+    auto const dfa = regex("ab_set", expr).to_DFA();
+    std::atomic_size_t mismatch_count{0};
+    std::atomic_size_t live_state_number{0};
+    run_concurrently([&] {
+      // regex parsing shares the grammar of the alphabet
+      auto const local_dfa = regex("ab_set", expr).to_DFA();
+      for (auto const &input : inputs) {
+        if (dfa.recognize(input) != local_dfa.recognize(input)) {
+          mismatch_count++;
+        }
+      }
+      live_state_number += dfa.get_live_states().size();
+    });
+    CHECK(mismatch_count == 0);
+    CHECK(live_state_number == 8 * dfa.get_live_states().size());
+  }
+
+  SUBCASE("regex to DFA") {
+    regex const shared_regex("ab_set", expr);
+    auto const expected_dfa = regex("ab_set", expr).to_DFA();
+    std::atomic_size_t mismatch_count{0};
+    run_concurrently([&] {
+      for (size_t round = 0; round < 10; round++) {
+        if (!shared_regex.to_DFA().language_equivalent_with(expected_dfa)) {
+          mismatch_count++;
+        }
+      }
+    });
+    CHECK(mismatch_count == 0);
+  }
+
+  SUBCASE("LR(1) parse") {
+    CFG::production_set_type productions;
+    productions["S"] = {{'a', "S", 'b'}, {}};
+    // the parsing tables are built by the first parses of some threads
+    LALR_grammar const grammar("ab_set", "S", productions);
+    std::atomic_size_t mismatch_count{0};
+    run_concurrently([&] {
+      for (auto const &input : inputs) {
+        auto const expected = input.empty() || input == U"ab";
+        if ((grammar.get_parse_tree(input) != nullptr) != expected) {
+          mismatch_count++;
+        }
+        if (grammar.GLR_parse(input) != expected) {
+          mismatch_count++;
+        }
+      }
+    });
+    CHECK(mismatch_count == 0);
+  }
+}
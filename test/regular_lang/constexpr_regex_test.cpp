@@ -0,0 +1,58 @@
+/*!
+ * \file constexpr_regex_test.cpp
+ *
+ * \brief
+ */
+#include <doctest/doctest.h>
+
+#include "regular_lang/constexpr_regex.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+namespace {
+  constexpr auto abb_dfa = compile_regex<U"(a|b)*abb">();
+  static_assert(abb_dfa.recognize(U"abb"));
+  static_assert(abb_dfa.recognize(U"babaabb"));
+  static_assert(!abb_dfa.recognize(U"ab"));
+  static_assert(!abb_dfa.recognize(U"abbc"));
+
+  constexpr auto identifier_dfa = compile_regex<U"[a-zA-Z_][a-zA-Z0-9_]*">();
+  static_assert(identifier_dfa.recognize(U"_tmp0"));
+  static_assert(!identifier_dfa.recognize(U"0tmp"));
+  static_assert(!identifier_dfa.recognize(U""));
+} // namespace
+
+TEST_CASE("constexpr regex") {
+  SUBCASE("ab_set") {
+    auto alphabet = ALPHABET::get("ab_set");
+    CHECK(abb_dfa.to_DFA(alphabet).language_equivalent_with(
+        regex(alphabet, U"(a|b)*abb").to_DFA()));
+
+    constexpr auto dfa = compile_regex<U"a+b?|(ab)*">();
+    CHECK(dfa.to_DFA(alphabet).language_equivalent_with(
+        regex(alphabet, U"a+b?|(ab)*").to_DFA()));
+  }
+
+  SUBCASE("printable-ASCII") {
+    auto alphabet = ALPHABET::get("printable-ASCII");
+    CHECK(identifier_dfa.to_DFA(alphabet).language_equivalent_with(
+        regex(alphabet, U"[a-zA-Z_][a-zA-Z0-9_]*").to_DFA()));
+
+    constexpr auto dfa = compile_regex<U"[^0-9]+\\.(x|[0-3]?)">();
+    CHECK(dfa.to_DFA(alphabet).language_equivalent_with(
+        regex(alphabet, U"[^0-9]+\\.(x|[0-3]?)").to_DFA()));
+
+    constexpr auto dot_dfa = compile_regex<U"a.*b">();
+    CHECK(dot_dfa.to_DFA(alphabet).language_equivalent_with(
+        regex(alphabet, U"a.*b").to_DFA()));
+    CHECK(dot_dfa.recognize(U"a?!b"));
+  }
+
+  SUBCASE("empty alternative") {
+    for (auto const *expr : {U"a|", U"|b", U"a||b", U"(|a)", U"(a|)"}) {
+      CHECK_THROWS_AS(constexpr_regex_detail::compile(expr),
+                      std::invalid_argument);
+    }
+  }
+}
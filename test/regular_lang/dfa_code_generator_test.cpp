@@ -0,0 +1,61 @@
+/*!
+ * \file dfa_code_generator_test.cpp
+ *
+ * \brief 测试生成的DFA匹配代码
+ */
+#include <doctest/doctest.h>
+
+#include "abb_match.hpp"
+#include "abb_search.hpp"
+#include "regular_lang/dfa_code_generator.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+namespace {
+  std::vector<symbol_string> all_strings(const symbol_string &symbols,
+                                         size_t max_length) {
+    std::vector<symbol_string> strings{{}};
+    for (size_t i = 0; i < strings.size(); i++) {
+      if (strings[i].size() == max_length) {
+        continue;
+      }
+      for (auto const symbol : symbols) {
+        strings.push_back(strings[i] + symbol);
+      }
+    }
+    return strings;
+  }
+} // namespace
+
+TEST_CASE("generated matcher") {
+  auto dfa = regex("ab_set", U"(a|b)*abb").to_DFA();
+  static_assert(abb_match(U"babb"));
+  static_assert(!abb_match(U"abba"));
+
+  for (auto const &str : all_strings(U"abc", 6)) {
+    CHECK_EQ(abb_match(str), dfa.recognize(str));
+
+    auto first_end = symbol_string::npos;
+    for (size_t end = 0; end <= str.size() && first_end == symbol_string::npos;
+         end++) {
+      for (size_t begin = 0; begin <= end; begin++) {
+        if (dfa.recognize(str.substr(begin, end - begin))) {
+          first_end = end;
+          break;
+        }
+      }
+    }
+    CHECK_EQ(abb_search(str), first_end);
+  }
+}
+
+TEST_CASE("generate matcher code") {
+  auto dfa = regex("ab_set", U"a*").to_DFA();
+  matcher_generation_option option;
+  option.function_name = "a_star";
+  option.namespace_name = "generated";
+  auto code = generate_cpp_matcher(dfa, option);
+  CHECK(code.contains("constexpr bool a_star(std::u32string_view input)"));
+  CHECK(code.contains("namespace generated {"));
+}
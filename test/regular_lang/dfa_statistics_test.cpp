@@ -0,0 +1,74 @@
+/*!
+ * \file dfa_statistics_test.cpp
+ *
+ * \brief
+ */
+#include <doctest/doctest.h>
+
+#include "regular_lang/dfa_statistics.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+TEST_CASE("DFA language statistics") {
+  // strings ending with abb, there are 2^(n-3) of length n >= 3
+  auto const dfa = regex("ab_set", U"(a|b)*abb").to_DFA();
+  DFA_language_statistics const statistics(dfa);
+
+  SUBCASE("count") {
+    auto const counts = statistics.count_up_to(6);
+    CHECK_EQ(counts.size(), 7);
+    CHECK_EQ(counts[2], 0);
+    CHECK_EQ(counts[3], 1);
+    CHECK_EQ(counts[6], 8);
+    CHECK_EQ(statistics.count(10), 128);
+    DFA_language_statistics::count_type expected = 1;
+    expected <<= 197;
+    CHECK_EQ(statistics.count(200), expected);
+  }
+
+  SUBCASE("count modulo") {
+    CHECK_EQ(statistics.count_modulo(10, 1000), 128);
+    uint64_t const modulus = 1000000007;
+    uint64_t const length = 1000000000000;
+    uint64_t expected = 1;
+    uint64_t base = 2;
+    for (auto exponent = length - 3; exponent != 0; exponent >>= 1) {
+      if ((exponent & 1) != 0) {
+        expected = expected * base % modulus;
+      }
+      base = base * base % modulus;
+    }
+    CHECK_EQ(statistics.count_modulo(length, modulus), expected);
+  }
+
+  SUBCASE("enumerate") {
+    auto enumerator = statistics.enumerate();
+    for (auto const *expected :
+         {U"abb", U"aabb", U"babb", U"aaabb", U"ababb", U"baabb"}) {
+      auto str = enumerator.next();
+      REQUIRE(str.has_value());
+      CHECK(*str == expected);
+    }
+
+    auto const finite_dfa = regex("ab_set", U"a|ab|b?").to_DFA();
+    DFA_language_statistics const finite_statistics(finite_dfa);
+    auto finite_enumerator = finite_statistics.enumerate();
+    std::vector<symbol_string> strings;
+    while (auto str = finite_enumerator.next()) {
+      strings.emplace_back(std::move(*str));
+    }
+    CHECK(strings == std::vector<symbol_string>{U"", U"a", U"b", U"ab"});
+  }
+
+  SUBCASE("sample") {
+    std::mt19937_64 generator(0);
+    for (size_t i = 0; i < 10; i++) {
+      auto str = statistics.sample(8, generator);
+      REQUIRE(str.has_value());
+      CHECK_EQ(str->size(), 8);
+      CHECK(dfa.recognize(*str));
+    }
+    CHECK(!statistics.sample(2, generator).has_value());
+  }
+}
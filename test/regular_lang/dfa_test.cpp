@@ -141,3 +141,82 @@ TEST_CASE("draw") {
           {4});
   std::cout << dfa.MMA_draw() << std::endl;
 }
+
+TEST_CASE("language equivalence") {
+  DFA dfa({0, 1, 2, 3}, "ab_set", 0,
+          {
+              {{0, 'a'}, 1},
+              {{0, 'b'}, 0},
+              {{1, 'a'}, 1},
+              {{1, 'b'}, 2},
+              {{2, 'a'}, 1},
+              {{2, 'b'}, 3},
+              {{3, 'a'}, 1},
+              {{3, 'b'}, 0},
+          },
+          {3});
+  DFA non_minimal_dfa({0, 1, 2, 3, 4}, "ab_set", 0,
+                      {
+                          {{0, 'a'}, 1},
+                          {{0, 'b'}, 2},
+                          {{1, 'a'}, 1},
+                          {{1, 'b'}, 3},
+                          {{2, 'a'}, 1},
+                          {{2, 'b'}, 2},
+                          {{3, 'a'}, 1},
+                          {{3, 'b'}, 4},
+                          {{4, 'a'}, 1},
+                          {{4, 'b'}, 2},
+                      },
+                      {4});
+  CHECK(!dfa.equivalent_with(non_minimal_dfa));
+  CHECK(dfa.language_equivalent_with(non_minimal_dfa));
+  CHECK(non_minimal_dfa.language_equivalent_with(dfa));
+
+  DFA another_dfa({0, 1, 2}, "ab_set", 0,
+                  {
+                      {{0, 'a'}, 1},
+                      {{0, 'b'}, 0},
+                      {{1, 'a'}, 1},
+                      {{1, 'b'}, 2},
+                      {{2, 'a'}, 1},
+                      {{2, 'b'}, 0},
+                  },
+                  {2});
+  auto str = dfa.get_distinguishing_string(another_dfa);
+  REQUIRE(str.has_value());
+  CHECK_EQ(*str, U"ab");
+  CHECK(dfa.recognize(*str) != another_dfa.recognize(*str));
+}
+
+TEST_CASE("trim") {
+  // state 3 is unreachable, states 2 and 4 are dead
+  DFA dfa({0, 1, 2, 3, 4}, "ab_set", 0,
+          {
+              {{0, 'a'}, 1},
+              {{0, 'b'}, 2},
+              {{1, 'a'}, 1},
+              {{1, 'b'}, 4},
+              {{2, 'a'}, 4},
+              {{2, 'b'}, 2},
+              {{3, 'a'}, 1},
+              {{3, 'b'}, 0},
+              {{4, 'a'}, 2},
+              {{4, 'b'}, 4},
+          },
+          {1});
+  CHECK(dfa.is_live_state(0));
+  CHECK(dfa.is_live_state(3));
+  CHECK(!dfa.is_live_state(2));
+  CHECK(!dfa.is_live_state(4));
+  CHECK_EQ(dfa.get_live_states(), DFA::state_set_type{0, 1, 3});
+
+  auto trimmed_dfa = dfa.trim();
+  CHECK_EQ(trimmed_dfa.get_states().size(), 3);
+  CHECK(trimmed_dfa.language_equivalent_with(dfa));
+  CHECK_EQ(dfa.minimize().first.get_states().size(), 3);
+
+  auto empty_dfa = dfa.complement().intersect(dfa).trim();
+  CHECK_EQ(empty_dfa.get_states().size(), 1);
+  CHECK(empty_dfa.get_final_states().empty());
+}
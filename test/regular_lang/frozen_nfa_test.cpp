@@ -0,0 +1,47 @@
+/*!
+ * \file frozen_nfa_test.cpp
+ *
+ * \brief
+ */
+#include <doctest/doctest.h>
+
+#include "regular_lang/frozen_nfa.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+TEST_CASE("frozen NFA") {
+  auto const nfa = regex("ab_set", U"(a|b)*abb(a|b)?|b+").to_NFA();
+  frozen_NFA const frozen_nfa(nfa);
+  CHECK_EQ(frozen_nfa.get_state_number(), nfa.get_states().size());
+
+  SUBCASE("go") {
+    auto const start_set = frozen_nfa.get_start_set();
+    NFA::state_set_type original_start_set;
+    for (auto const s : start_set) {
+      original_start_set.insert(frozen_nfa.get_original_state(s));
+    }
+    CHECK_EQ(original_start_set, nfa.get_start_set());
+
+    for (auto const a : {'a', 'b'}) {
+      NFA::state_set_type next_states;
+      for (auto const s : frozen_nfa.go(start_set, a)) {
+        next_states.insert(frozen_nfa.get_original_state(s));
+      }
+      CHECK_EQ(next_states, nfa.go(nfa.get_start_set(), a));
+    }
+  }
+
+  SUBCASE("recognize") {
+    // NFA::recognize runs on a frozen NFA too
+    auto const dfa = nfa.to_DFA_with_mapping().first;
+    for (auto const *str :
+         {U"", U"abb", U"aabba", U"abbab", U"bbb", U"ab", U"abba"}) {
+      CHECK_EQ(frozen_nfa.recognize(str), dfa.recognize(str));
+    }
+  }
+
+  SUBCASE("to_DFA") {
+    CHECK(frozen_nfa.to_DFA() == nfa.to_DFA_with_mapping().first);
+  }
+}
@@ -0,0 +1,42 @@
+/*!
+ * \file instrumentation_test.cpp
+ *
+ * \brief
+ */
+#include <thread>
+
+#include <doctest/doctest.h>
+
+#include "instrumentation.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+TEST_CASE("instrumentation") {
+  using instrumentation::counter;
+  instrumentation::reset();
+  regex const reg("ab_set", U"(a|b)*abb");
+  auto const dfa = reg.to_DFA();
+  CHECK(dfa.recognize(U"aabb"));
+  CHECK(reg.to_NFA().recognize(U"aabb"));
+
+  auto const thread_counters = instrumentation::get_thread_counters();
+  std::jthread([] {
+    static_cast<void>(regex("ab_set", U"a*").to_DFA().recognize(U"aa"));
+  }).join();
+  auto const global_counters = instrumentation::get_global_counters();
+  auto const json = global_counters.to_json();
+  CHECK(json.starts_with("{\"NFA_step\":"));
+  CHECK(json.contains("\"CNF_cell_merge\":"));
+
+  if constexpr (instrumentation::enabled) {
+    CHECK_EQ(thread_counters[counter::DFA_step], 4);
+    CHECK(thread_counters[counter::regex_to_DFA_state] > 0);
+    CHECK(thread_counters[counter::NFA_step] > 0);
+    CHECK_EQ(global_counters[counter::regex_parse], 2);
+    CHECK(global_counters[counter::DFA_step] >
+          thread_counters[counter::DFA_step]);
+  } else {
+    CHECK_EQ(global_counters[counter::DFA_step], 0);
+  }
+}
@@ -8,6 +8,7 @@
 #include "context_free_lang/ll_grammar.hpp"
 #include "context_free_lang/model_transform.hpp"
 #include "regular_lang/nfa.hpp"
+#include "regular_lang/regex.hpp"
 
 using namespace cyy::computation;
 TEST_CASE("recognize NFA") {
@@ -94,3 +95,34 @@ TEST_CASE("draw") {
           {2, 4}, {{0, {1, 3}}});
   std::cout << nfa.MMA_draw() << std::endl;
 }
+TEST_CASE("remove epsilon transitions and reduce") {
+  NFA nfa({0, 1, 2, 3, 4, 5, 6}, "ab_set", 0,
+          {
+              {{1, 'a'}, {2}},
+              {{2, 'a'}, {2}},
+              {{3, 'a'}, {4}},
+              {{4, 'a'}, {4}},
+              {{5, 'b'}, {6}},
+          },
+          {2, 4}, {{0, {1, 3}}});
+  auto const epsilon_free_nfa = nfa.remove_epsilon_transitions();
+  CHECK(epsilon_free_nfa.get_epsilon_transition_function().empty());
+  CHECK(epsilon_free_nfa.to_DFA().language_equivalent_with(nfa.to_DFA()));
+
+  auto const reduced_nfa = nfa.reduce();
+  CHECK(reduced_nfa.get_epsilon_transition_function().empty());
+  // 2 and 4 are bisimilar, 5 and 6 are useless
+  CHECK_EQ(reduced_nfa.get_states().size(), 2);
+  CHECK(reduced_nfa.to_DFA().language_equivalent_with(nfa.to_DFA()));
+}
+
+TEST_CASE("reduce regex NFA") {
+  // the final states of these NFAs are entered only through epsilon
+  // transitions
+  for (auto const *expr : {U"a|b", U"(a|b)*abb", U"a*b*", U"(ab|ba)*a?"}) {
+    auto const nfa = regex("ab_set", expr).to_NFA();
+    auto const reduced_nfa = nfa.reduce();
+    CHECK(reduced_nfa.get_epsilon_transition_function().empty());
+    CHECK(reduced_nfa.to_DFA().language_equivalent_with(nfa.to_DFA()));
+  }
+}
@@ -0,0 +1,67 @@
+/*!
+ * \file regex_to_matcher.cpp
+ *
+ * \brief generate a C++ matcher header from an ASCII regex file
+ */
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "regular_lang/dfa_code_generator.hpp"
+#include "regular_lang/regex.hpp"
+
+using namespace cyy::computation;
+
+int main(int argc, char **argv) {
+  if (argc < 5) {
+    std::cerr << "usage: " << argv[0]
+              << " regex_file alphabet function_name output_header "
+                 "[--namespace name] [--search]\n";
+    return 1;
+  }
+  std::ifstream is(argv[1]);
+  if (!is) {
+    std::cerr << "can't open " << argv[1] << '\n';
+    return 1;
+  }
+  std::string content{std::istreambuf_iterator<char>(is),
+                      std::istreambuf_iterator<char>()};
+  while (!content.empty() &&
+         (content.back() == '\n' || content.back() == '\r')) {
+    content.pop_back();
+  }
+  symbol_string expr;
+  for (auto const c : content) {
+    expr.push_back(static_cast<symbol_type>(static_cast<unsigned char>(c)));
+  }
+
+  matcher_generation_option option;
+  option.function_name = argv[3];
+  for (int i = 5; i < argc; i++) {
+    std::string_view const arg = argv[i];
+    if (arg == "--search") {
+      option.search_mode = true;
+    } else if (arg == "--namespace" && i + 1 < argc) {
+      option.namespace_name = argv[++i];
+    } else {
+      std::cerr << "unknown argument " << arg << '\n';
+      return 1;
+    }
+  }
+
+  try {
+    auto const code =
+        generate_cpp_matcher(regex(argv[2], expr).to_DFA(), option);
+    std::ofstream os(argv[4], std::ios::trunc);
+    os << code;
+    if (!os) {
+      std::cerr << "can't write " << argv[4] << '\n';
+      return 1;
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}